@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+/*
+ * Lock contention benchmark for SSD1306 driver
+ * Runs 2-4 drawing tasks, pinned alternately to both cores, each drawing in
+ * its own horizontal region, plus a flush task. Compares one framebuffer
+ * lock against per-band locks.
+ */
+#include <driver/i2c_master.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <ssd1306.h>
+
+#define BENCH_MS     2000
+#define FLUSH_PERIOD 33 // ms, ~30 FPS
+#define WIDTH        128
+#define HEIGHT       64
+
+static const char *TAG = "SSD1306_LOCK_BENCH";
+
+typedef struct {
+    ssd1306_handle_t  d;
+    int               y0, rows;
+    volatile bool    *stop;
+    uint32_t          ops;
+    int64_t           wait_us; // time spent inside drawing calls
+    SemaphoreHandle_t done;
+} worker_t;
+
+static void draw_worker(void *arg) {
+    worker_t *w = arg;
+    int       x = 0;
+    while (!*w->stop) {
+        const int64_t t0 = esp_timer_get_time();
+        ssd1306_draw_rect(w->d, x, w->y0, 8, w->rows, (x & 8) != 0);
+        ssd1306_draw_line(w->d, 0, w->y0, WIDTH - 1, w->y0 + w->rows - 1,
+                          true);
+        w->wait_us += esp_timer_get_time() - t0;
+        w->ops += 2;
+        x = (x + 1) % (WIDTH - 8);
+    }
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+static void flush_worker(void *arg) {
+    worker_t *w = arg;
+    while (!*w->stop) {
+        ssd1306_display(w->d);
+        vTaskDelay(pdMS_TO_TICKS(FLUSH_PERIOD));
+    }
+    xSemaphoreGive(w->done);
+    vTaskDelete(NULL);
+}
+
+static void run(int n_tasks, uint8_t bands) {
+    ssd1306_config_t cfg = {
+        .width      = WIDTH,
+        .height     = HEIGHT,
+        .lock_bands = bands,
+        .iface.i2c =
+            {
+                .port     = I2C_NUM_0,
+                .addr     = 0x3C,
+                .rst_gpio = GPIO_NUM_NC,
+            },
+    };
+    ssd1306_handle_t d = NULL;
+    ESP_ERROR_CHECK(ssd1306_new_i2c(&cfg, &d));
+
+    volatile bool     stop = false;
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(n_tasks + 1, 0);
+    worker_t          w[5] = {0};
+    const int         rows = HEIGHT / n_tasks; // page aligned for 2 and 4
+
+    for (int i = 0; i <= n_tasks; ++i) {
+        w[i] = (worker_t){
+            .d = d, .y0 = i * rows, .rows = rows, .stop = &stop, .done = done};
+    }
+    for (int i = 0; i < n_tasks; ++i) {
+        xTaskCreatePinnedToCore(draw_worker, "draw", 3072, &w[i], 5, NULL,
+                                i & 1);
+    }
+    xTaskCreate(flush_worker, "flush", 3072, &w[n_tasks], 6, NULL);
+
+    vTaskDelay(pdMS_TO_TICKS(BENCH_MS));
+    stop = true;
+    for (int i = 0; i <= n_tasks; ++i)
+        xSemaphoreTake(done, portMAX_DELAY);
+
+    uint32_t ops = 0;
+    int64_t  wait_us = 0;
+    for (int i = 0; i < n_tasks; ++i) {
+        ops += w[i].ops;
+        wait_us += w[i].wait_us;
+    }
+    ssd1306_stats_t st;
+    ssd1306_get_stats(d, &st);
+    ESP_LOGI(TAG,
+             "%d tasks, %u band(s): %lu ops/s, %lu us/op, flush lock hold "
+             "max %lu us",
+             n_tasks, bands ? bands : 1,
+             (unsigned long)(ops * 1000ULL / BENCH_MS),
+             (unsigned long)(ops ? wait_us / ops : 0),
+             (unsigned long)st.lock_hold_us_max);
+
+    vSemaphoreDelete(done);
+    ESP_ERROR_CHECK(ssd1306_del(d));
+}
+
+void app_main(void) {
+    i2c_master_bus_config_t bus_cfg = {
+        .i2c_port                     = I2C_NUM_0,
+        .sda_io_num                   = GPIO_NUM_21,
+        .scl_io_num                   = GPIO_NUM_22,
+        .clk_source                   = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt            = 7,
+        .flags.enable_internal_pullup = true,
+    };
+    i2c_master_bus_handle_t bus = NULL;
+    ESP_ERROR_CHECK(i2c_new_master_bus(&bus_cfg, &bus));
+
+    for (int n = 2; n <= 4; n += 2) {
+        run(n, 1);
+        run(n, SSD1306_MAX_LOCK_BANDS);
+    }
+}
@@ -9,6 +9,7 @@
 #include <driver/gpio.h>
 #include <driver/i2c_types.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -22,6 +23,7 @@ extern "C" {
 typedef enum {
     SSD1306_I2C = 0, /*!< I2C connection */
     SSD1306_SPI = 1, /*!< SPI connection */
+    SSD1306_CANVAS = 2, /*!< Virtual canvas tiled over several displays */
 } ssd1306_bus_t;
 
 /**
@@ -38,6 +40,11 @@ typedef struct {
     const uint8_t *bitmap; /*!< Pointer to font bitmap data */
 } ssd1306_font_t;
 
+/**
+ * @brief I2C multiplexer (TCA9548A-style) handle type.
+ */
+typedef struct ssd1306_i2c_mux_t *ssd1306_i2c_mux_handle_t;
+
 /**
  * @brief I2C interface configuration.
  */
@@ -45,8 +52,39 @@ typedef struct {
     i2c_port_num_t port;     /*!< I2C port number */
     gpio_num_t     rst_gpio; /*!< Optional reset GPIO (GPIO_NUM_NC if unused) */
     uint8_t        addr;     /*!< 7-bit I2C address (usually 0x3C or 0x3D) */
+    ssd1306_i2c_mux_handle_t mux; /*!< Mux the panel sits behind, or NULL */
+    uint8_t mux_channel; /*!< Mux channel (0-7), used when mux is set */
+    uint8_t async_depth; /*!< Transactions queued ahead without blocking; the
+                              bus must be created with trans_queue_depth of
+                              at least this (0 = blocking writes). That
+                              makes every write on the bus asynchronous, so
+                              all panels on it must be async: binding a
+                              blocking (or static) panel to a port with
+                              async ones, or the reverse, fails with
+                              ESP_ERR_INVALID_STATE. Blocking panels need a
+                              bus without trans_queue_depth. */
+    void (*on_idle)(void *arg); /*!< Async: called from the I2C ISR when all
+                                     queued transactions have been sent */
+    void *on_idle_arg;          /*!< Argument passed to on_idle */
 } ssd1306_i2c_cfg_t;
 
+/**
+ * @brief How the SPI transport drives the D/C pin.
+ */
+typedef enum {
+    SSD1306_SPI_DC_CALLBACK = 0, /*!< Pre-transaction callback (ISR context)
+                                      sets D/C before every transaction */
+    SSD1306_SPI_DC_DIRECT,       /*!< Set from the sending task, only when it
+                                      changes; the bus is held for a flush */
+    SSD1306_SPI_DC_DEDICATED,    /*!< Like DIRECT through a dedicated-GPIO
+                                      bundle. Bundles are per CPU core: it is
+                                      opened on the core of the first send
+                                      (the flush task's with a pipeline), and
+                                      D/C falls back to DIRECT for good when a
+                                      send comes from another core, or where
+                                      the chip has no dedicated GPIO */
+} ssd1306_spi_dc_mode_t;
+
 /**
  * @brief SPI interface configuration.
  */
@@ -56,15 +94,169 @@ typedef struct {
     int dc_gpio;  /*!< Data/Command GPIO number (required) */
     int rst_gpio; /*!< Optional reset GPIO (GPIO_NUM_NC if unused) */
     int clk_hz;   /*!< SPI clock frequency in Hz (default ~8 MHz if 0) */
+    ssd1306_spi_dc_mode_t dc_mode; /*!< D/C switching method */
 } ssd1306_spi_cfg_t;
 
+/**
+ * @brief Display handle type.
+ */
+typedef struct ssd1306_t *ssd1306_handle_t;
+
+/** Maximum number of displays a canvas can span. */
+#define SSD1306_CANVAS_MAX_TILES 4
+
+/**
+ * @brief Placement of one display on a virtual canvas.
+ */
+typedef struct {
+    ssd1306_handle_t panel; /*!< Initialized display, owned by the canvas */
+    uint16_t         x;     /*!< Left edge on the canvas */
+    uint16_t         y;     /*!< Top edge on the canvas (multiple of 8) */
+} ssd1306_tile_t;
+
+/**
+ * @brief Virtual canvas configuration.
+ */
+typedef struct {
+    const ssd1306_tile_t *tiles;   /*!< Tiles covering the canvas */
+    uint8_t               n_tiles; /*!< Number of tiles */
+} ssd1306_canvas_cfg_t;
+
+/** Maximum number of framebuffer lock bands (one per page on 64-row panels). */
+#define SSD1306_MAX_LOCK_BANDS 8
+
+/**
+ * @brief Bus sharing limits for display traffic.
+ *
+ * Bounds how long a flush holds a shared bus at a time, so other devices on
+ * it (sensors) get regular turns. All zero means no limits.
+ */
+typedef struct {
+    uint16_t max_xfer_bytes; /*!< Max bytes per bus transaction (0 = no
+                                  limit beyond the transport's own) */
+    uint32_t gap_us; /*!< Min pause between display transactions of a flush */
+    void (*yield_cb)(void *arg); /*!< Called between transactions instead of
+                                      pausing for gap_us, if set */
+    void *yield_arg;             /*!< Argument passed to yield_cb */
+} ssd1306_fairness_t;
+
+/**
+ * @brief Bus cost parameters used to plan flushes.
+ *
+ * In nanoseconds, since a byte on fast SPI takes well under a microsecond.
+ * With byte_ns = 0 the transport's defaults are refined by a short
+ * measurement when the handle is created.
+ */
+typedef struct {
+    uint32_t setup_ns; /*!< Fixed cost per data transaction */
+    uint32_t byte_ns;  /*!< Cost per payload byte */
+    uint32_t cmd_ns;   /*!< Cost of addressing a window (column/page cmds) */
+} ssd1306_bus_cost_t;
+
+/**
+ * @brief Display controller chip.
+ */
+typedef enum {
+    SSD1306_CTRL_SSD1306 = 0, /*!< SSD1306 (128-column RAM) */
+    SSD1306_CTRL_SH1106,      /*!< SH1106: 132-column RAM, page addressing
+                                   only (no column/page windows) */
+    SSD1306_CTRL_SSD1309,     /*!< SSD1309: like SSD1306 without charge pump */
+    SSD1306_CTRL_SSD1305,     /*!< SSD1305: 132-column RAM, no charge pump */
+    SSD1306_CTRL_COUNT,
+} ssd1306_controller_t;
+
+/**
+ * @brief ssd1306_config_t::col_offset value selecting the controller's
+ *        default: 128-column panels centered in 132-column RAM, else 0.
+ */
+#define SSD1306_COL_OFFSET_AUTO (-1)
+
+/**
+ * @brief Built-in panel profiles for the init sequence.
+ */
+typedef enum {
+    SSD1306_PANEL_INTERNAL_VCC = 0, /*!< Internal charge pump (most modules) */
+    SSD1306_PANEL_EXTERNAL_VCC,     /*!< VCC supplied externally: charge pump
+                                         off, shorter precharge */
+    SSD1306_PANEL_COUNT,
+} ssd1306_panel_t;
+
+/**
+ * @brief Panel profile and init sequence overrides.
+ *
+ * Zero fields keep the profile's value (the raw value 0 itself cannot be
+ * selected; use init_cmds for that). Checked when the handle is created.
+ */
+typedef struct {
+    ssd1306_panel_t profile; /*!< Built-in profile (the charge pump setting
+                                  is ignored on controllers without one) */
+    uint8_t clock_div; /*!< 0xD5: oscillator frequency (high nibble) and
+                            divide ratio - 1 (low nibble); a faster clock
+                            raises the panel refresh rate */
+    uint8_t precharge; /*!< 0xD9: phase 2 (high nibble) and phase 1 (low
+                            nibble) periods, both non-zero */
+    uint8_t vcomh;     /*!< 0xDB: VCOMH deselect level (bits 4-6) */
+    uint8_t contrast;  /*!< 0x81: contrast */
+    uint8_t com_pins;  /*!< 0xDA: 0x02, 0x12, 0x22 or 0x32 (default by
+                            height) */
+    const uint8_t *init_cmds; /*!< Complete command table sent instead of the
+                                   built-in sequence (also on recovery; must
+                                   outlive the handle), or NULL. Excludes
+                                   the overrides above. */
+    size_t init_len;          /*!< Bytes in init_cmds */
+} ssd1306_panel_cfg_t;
+
+/**
+ * @brief Driver buffers, for allocator hooks and placement reports.
+ */
+typedef enum {
+    SSD1306_BUF_FB = 0, /*!< Framebuffer */
+    SSD1306_BUF_STAGE,  /*!< Staging buffer flushes transmit from */
+    SSD1306_BUF_PIPE,   /*!< Pipeline frame slots (transmitted from) */
+    SSD1306_BUF_QUEUE,  /*!< Render queue ring (written from ISRs) */
+    SSD1306_BUF_GATHER, /*!< Partial-flush rows packed for one transaction */
+    SSD1306_BUF_XFER,   /*!< Queued transaction slots (async I2C) */
+    SSD1306_BUF_COUNT,
+} ssd1306_buf_kind_t;
+
+/**
+ * @brief Allocator hooks for driver buffers.
+ *
+ * The driver passes the heap capabilities it would use by default: DMA-capable
+ * internal RAM for buffers that are drawn into or transmitted from, and
+ * internal RAM for the render queue ring, which ssd1306_post_from_isr()
+ * writes. Hooks must honour MALLOC_CAP_INTERNAL for SSD1306_BUF_QUEUE.
+ *
+ * cold_in_psram is for buffers nothing touches on the hot path; no current
+ * buffer qualifies, so it has no effect yet.
+ */
+typedef struct {
+    void *(*alloc)(ssd1306_buf_kind_t kind, size_t size, uint32_t caps,
+                   void *arg); /*!< Zeroed allocation; NULL = heap_caps */
+    void (*free)(ssd1306_buf_kind_t kind, void *ptr,
+                 void *arg); /*!< Release; required with alloc */
+    void *arg;               /*!< Passed to the hooks */
+    bool  cold_in_psram;     /*!< PSRAM for cold buffers (none yet) */
+} ssd1306_alloc_cfg_t;
+
+/**
+ * @brief Where a driver buffer was placed.
+ */
+typedef struct {
+    const void *ptr;      /*!< Buffer (first one for multi-slot buffers) */
+    size_t      size;     /*!< Total bytes, 0 if not allocated */
+    bool        internal; /*!< In internal RAM */
+    bool        dma;      /*!< DMA capable */
+} ssd1306_buf_info_t;
+
 /**
  * @brief Display configuration structure for initialization.
  */
 typedef struct {
     union {
-        ssd1306_i2c_cfg_t i2c; /*!< I2C configuration */
-        ssd1306_spi_cfg_t spi; /*!< SPI configuration */
+        ssd1306_i2c_cfg_t    i2c;    /*!< I2C configuration */
+        ssd1306_spi_cfg_t    spi;    /*!< SPI configuration */
+        ssd1306_canvas_cfg_t canvas; /*!< Tiles of a virtual canvas */
     } iface;
 
     uint8_t *fb; /*!< Optional framebuffer pointer (NULL to auto-allocate) */
@@ -72,12 +264,216 @@ typedef struct {
     ssd1306_bus_t bus;    /*!< Selected bus type */
     uint16_t      width;  /*!< Display width in pixels */
     uint16_t      height; /*!< Display height in pixels */
+    uint8_t lock_bands; /*!< Lock the framebuffer in this many horizontal page
+                             bands (0/1 = one lock, max
+                             SSD1306_MAX_LOCK_BANDS) */
+    uint32_t lock_timeout_ms; /*!< Max wait for internal locks in drawing and
+                                   flush calls (0 = wait forever) */
+    ssd1306_fairness_t fairness; /*!< Bus sharing limits (zero = none) */
+    ssd1306_alloc_cfg_t alloc;   /*!< Buffer allocator (zero = defaults) */
+    ssd1306_bus_cost_t  bus_cost; /*!< Flush planning costs (zero = measure) */
+    ssd1306_panel_cfg_t panel;    /*!< Panel profile and init overrides (zero
+                                       = internal charge pump) */
+    ssd1306_controller_t controller; /*!< Controller chip (zero = SSD1306) */
+    int16_t col_offset; /*!< RAM column of the panel's first column, or
+                             SSD1306_COL_OFFSET_AUTO for the controller
+                             default (set it for SH1106/SSD1305 modules
+                             wired like a 128-column SSD1306) */
+    uint8_t strip_buffers; /*!< Strip mode: keep 1 or 2 page-high strips
+                                instead of a framebuffer and render with
+                                ssd1306_draw_strips() (0 = framebuffer) */
+    uint32_t xfer_timeout_ms; /*!< Per-transaction bus timeout (0 = 100).
+                                   An SPI flush without fairness limits
+                                   first waits for the bus without a bound
+                                   (the driver allows no timeout there) */
+    uint32_t recover_max_ms;  /*!< Longest pause between recovery attempts
+                                   while the panel is unreachable (0 = 5000) */
+    bool lazy_init; /*!< Only reset the panel at creation; send the init
+                         sequence (and measure bus costs) with the first
+                         flush. Ignored in strip mode. */
+    bool warm_attach; /*!< The panel is still powered and configured (deep
+                           sleep wakeup, soft reboot): skip reset, init and
+                           cost measurement, only check that it answers.
+                           Falls back to a full init if it does not. Only
+                           I2C can tell (SPI has no ACK); on SPI an
+                           rtc_store that was not resumed forces a full
+                           init instead. RES# must stay high meanwhile
+                           (e.g. gpio_hold_en()). To keep the picture in
+                           sync, pass fb restored from RTC memory or use
+                           rtc_store. */
+    uint32_t *rtc_store; /*!< Optional RTC memory of SSD1306_RTC_STORE_WORDS()
+                              words (e.g. RTC_DATA_ATTR) holding the
+                              framebuffer and a copy of the panel contents
+                              across deep sleep; see ssd1306_rtc_save(). Not
+                              with fb, strip mode or a canvas. */
 } ssd1306_config_t;
 
+/** Bytes reserved for the handle in ssd1306_static_t. */
+#define SSD1306_STATIC_HANDLE_SIZE (112 * sizeof(void *))
+/** Bytes reserved for the bus context in ssd1306_static_t. */
+#define SSD1306_STATIC_BUS_CTX_SIZE (56 * sizeof(void *))
+
 /**
- * @brief Display handle type.
+ * @brief Caller-provided storage for heap-free handle creation.
+ *
+ * Must stay valid until ssd1306_del(). Only stage has to be set by the
+ * caller (gather is optional); the rest is owned by the driver.
  */
-typedef struct ssd1306_t *ssd1306_handle_t;
+typedef struct {
+    uint64_t handle[(SSD1306_STATIC_HANDLE_SIZE + 7) / 8]; /*!< Handle */
+    uint64_t bus_ctx[(SSD1306_STATIC_BUS_CTX_SIZE + 7) / 8]; /*!< Bus ctx */
+    StaticSemaphore_t locks[1 + SSD1306_MAX_LOCK_BANDS]; /*!< Mutexes */
+    uint8_t *stage;  /*!< Staging buffer of SSD1306_STAGE_LEN() bytes */
+    uint8_t *gather; /*!< Optional buffer of SSD1306_STAGE_LEN() bytes for
+                          single-transaction partial flushes, or NULL */
+} ssd1306_static_t;
+
+/** Staging (and gather) buffer length for ssd1306_static_t: the framebuffer
+ *  plus one byte of headroom for in-place I2C framing. */
+#define SSD1306_STAGE_LEN(w, h) ((size_t)(w) * (h) / 8 + 1)
+
+/** RTC store size in 32-bit words (ssd1306_config_t::rtc_store): a header,
+ *  the framebuffer and a copy of what the panel shows. */
+#define SSD1306_RTC_STORE_WORDS(w, h) (4 + ((size_t)(w) * (h) / 4 + 3) / 4)
+
+/**
+ * @brief Runtime statistics for a display handle.
+ *
+ * All durations are in microseconds.
+ */
+typedef struct {
+    uint32_t flushes;           /*!< Frames sent (ssd1306_display() calls or
+                                     completed ssd1306_display_step() frames) */
+    uint32_t flush_us_last;     /*!< Duration of the last flush */
+    uint32_t flush_us_max;      /*!< Longest flush */
+    uint32_t lock_hold_us_last; /*!< Drawing lock hold time, last flush */
+    uint32_t lock_hold_us_max;  /*!< Drawing lock hold time, worst flush */
+    uint32_t queue_drops;       /*!< Commands rejected because the queue was full */
+    uint32_t frames_merged; /*!< Pipeline frames replaced before being sent */
+    uint32_t lock_waits;         /*!< Lock acquisitions that had to wait */
+    uint32_t lock_wait_us_max;   /*!< Longest wait for a lock */
+    uint64_t lock_wait_us_total; /*!< Total time spent waiting for locks */
+    uint32_t lock_timeouts; /*!< Calls that gave up with ESP_ERR_TIMEOUT */
+    uint32_t bus_hold_us_max; /*!< Longest single bus transaction of a flush */
+    uint32_t bus_errors;      /*!< Flushes or recoveries that failed */
+    uint32_t recoveries; /*!< Panel re-initializations after bus errors */
+    bool     offline;    /*!< Panel unreachable; drawing continues in RAM */
+} ssd1306_stats_t;
+
+/** Maximum text length (including NUL) carried by a queued text command. */
+#define SSD1306_CMD_TEXT_MAX 24
+
+/**
+ * @brief Draw command types for the render queue.
+ */
+typedef enum {
+    SSD1306_CMD_CLEAR = 0, /*!< Clear the framebuffer */
+    SSD1306_CMD_PIXEL,     /*!< ssd1306_draw_pixel() */
+    SSD1306_CMD_RECT,      /*!< ssd1306_draw_rect() */
+    SSD1306_CMD_LINE,      /*!< ssd1306_draw_line() */
+    SSD1306_CMD_CIRCLE,    /*!< ssd1306_draw_circle() */
+    SSD1306_CMD_TEXT,      /*!< ssd1306_draw_text_scaled() */
+    SSD1306_CMD_FLUSH,     /*!< ssd1306_display() */
+} ssd1306_cmd_type_t;
+
+/**
+ * @brief Fixed-size draw command posted to the render queue.
+ *
+ * Arguments mirror the matching drawing call; text is copied into the command
+ * so the caller's string need not outlive the post.
+ */
+typedef struct {
+    ssd1306_cmd_type_t type; /*!< Command type */
+    union {
+        struct {
+            int16_t x, y;
+            bool    on;
+        } pixel;
+        struct {
+            int16_t x, y, w, h;
+            bool    fill;
+        } rect;
+        struct {
+            int16_t x0, y0, x1, y1;
+            bool    on;
+        } line;
+        struct {
+            int16_t x, y, r;
+            bool    fill;
+        } circle;
+        struct {
+            int16_t x, y;
+            uint8_t scale; /*!< 0 is treated as 1 */
+            bool    on;
+            char    str[SSD1306_CMD_TEXT_MAX];
+        } text;
+    };
+} ssd1306_cmd_t;
+
+/**
+ * @brief Render queue configuration.
+ *
+ * Zero-valued fields select the defaults.
+ */
+typedef struct {
+    uint16_t    depth;      /*!< Capacity in commands, power of two (32) */
+    uint32_t    stack_size; /*!< Render task stack size in bytes (3072) */
+    UBaseType_t priority;   /*!< Render task priority (5) */
+    bool auto_flush; /*!< Flush after every drained batch, not only on FLUSH */
+} ssd1306_queue_cfg_t;
+
+/** Maximum number of displays in a display group. */
+#define SSD1306_GROUP_MAX_PANELS 8
+
+/**
+ * @brief Display group handle type.
+ */
+typedef struct ssd1306_group_t *ssd1306_group_handle_t;
+
+/**
+ * @brief Display group configuration.
+ *
+ * Zero-valued fields select the defaults.
+ */
+typedef struct {
+    uint32_t default_deadline_ms; /*!< Deadline for requests without one (100) */
+    uint32_t    stack_size; /*!< Scheduler task stack size in bytes (3072) */
+    UBaseType_t priority;   /*!< Scheduler task priority (5) */
+} ssd1306_group_cfg_t;
+
+/**
+ * @brief Per-display statistics kept by a display group.
+ */
+typedef struct {
+    float    fps;             /*!< Achieved flushes per second (1 s window) */
+    uint32_t flushes;         /*!< Flushes performed by the group */
+    uint32_t queue_us_last;   /*!< Request-to-start delay of the last flush */
+    uint32_t queue_us_max;    /*!< Worst request-to-start delay */
+    uint32_t deadline_misses; /*!< Flushes that finished after the deadline */
+} ssd1306_group_stats_t;
+
+/**
+ * @brief Create a handle for an I2C multiplexer shared by several displays.
+ *
+ * The mux tracks its selected channel and only writes the channel register
+ * when a display on another channel is addressed. A flush selects its channel
+ * once and keeps the mux for the whole frame.
+ *
+ * @param[in]  port I2C port the mux is on (bus must be initialized).
+ * @param[in]  addr 7-bit mux address (0x70-0x77 for TCA9548A).
+ * @param[out] out  Returned mux handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_i2c_mux_new(i2c_port_num_t port, uint8_t addr,
+                              ssd1306_i2c_mux_handle_t *out);
+
+/**
+ * @brief Delete a mux handle. Delete the displays behind it first.
+ *
+ * @param mux Mux handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_i2c_mux_del(ssd1306_i2c_mux_handle_t mux);
 
 /**
  * @brief Create and initialize a new SSD1306 display on I2C.
@@ -97,6 +493,53 @@ esp_err_t ssd1306_new_i2c(const ssd1306_config_t *cfg, ssd1306_handle_t *out);
  */
 esp_err_t ssd1306_new_spi(const ssd1306_config_t *cfg, ssd1306_handle_t *out);
 
+/**
+ * @brief Create an I2C display without any heap allocation by the driver.
+ *
+ * Like ssd1306_new_i2c(), but the handle, bus context, locks and staging
+ * buffer live in mem, and cfg->fb must be provided. Note that ESP-IDF's I2C
+ * driver still allocates its own device object when the display is added to
+ * the bus. Render queue, pipeline, groups and canvases are not covered.
+ *
+ * @param[in]  cfg Configuration; fb and fb_len are required.
+ * @param[in]  mem Storage for the handle, with mem->stage set.
+ * @param[out] out Returned display handle.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if fb or stage is missing.
+ */
+esp_err_t ssd1306_new_i2c_static(const ssd1306_config_t *cfg,
+                                 ssd1306_static_t *mem, ssd1306_handle_t *out);
+
+/**
+ * @brief Create an SPI display without any heap allocation by the driver.
+ *
+ * See ssd1306_new_i2c_static(); spi_bus_add_device() still allocates inside
+ * ESP-IDF.
+ *
+ * @param[in]  cfg Configuration; fb and fb_len are required.
+ * @param[in]  mem Storage for the handle, with mem->stage set.
+ * @param[out] out Returned display handle.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if fb or stage is missing.
+ */
+esp_err_t ssd1306_new_spi_static(const ssd1306_config_t *cfg,
+                                 ssd1306_static_t *mem, ssd1306_handle_t *out);
+
+/**
+ * @brief Create a virtual canvas spanning several displays.
+ *
+ * The canvas is a regular handle with one framebuffer covering cfg->width x
+ * cfg->height; drawing ignores panel boundaries. On flush the dirty region is
+ * split by tile and each slice is sent to its display, in parallel for
+ * displays on different buses. The canvas takes ownership of the tile
+ * displays: ssd1306_del() on the canvas deletes them too. Do not draw on or
+ * flush the tiles directly.
+ *
+ * @param[in]  cfg Configuration; tiles are given in cfg->iface.canvas.
+ * @param[out] out Returned canvas handle.
+ * @return ESP_OK on success, error otherwise.
+ */
+esp_err_t ssd1306_new_canvas(const ssd1306_config_t *cfg,
+                             ssd1306_handle_t       *out);
+
 /**
  * @brief Set the active font for text drawing.
  *
@@ -106,6 +549,21 @@ esp_err_t ssd1306_new_spi(const ssd1306_config_t *cfg, ssd1306_handle_t *out);
  */
 esp_err_t ssd1306_set_font(ssd1306_handle_t h, const ssd1306_font_t *font);
 
+/**
+ * @brief Set how long drawing and flush calls may wait for internal locks.
+ *
+ * When the timeout expires the call returns ESP_ERR_TIMEOUT without touching
+ * the framebuffer or the bus, so a real-time task can skip a display update
+ * instead of blocking behind another task's flush. Waits are counted in
+ * ssd1306_stats_t.
+ *
+ * @param h     Display handle.
+ * @param ticks Timeout in ticks; 0 only tries the lock, portMAX_DELAY waits
+ *              forever (the default).
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_set_lock_timeout(ssd1306_handle_t h, TickType_t ticks);
+
 /**
  * @brief Delete a display handle and free associated resources.
  *
@@ -241,11 +699,316 @@ esp_err_t ssd1306_draw_text_wrapped_scaled(ssd1306_handle_t h, int x, int y,
 /**
  * @brief Send the current framebuffer to the display (flush).
  *
+ * Not available in strip mode; use ssd1306_draw_strips() there.
+ *
+ * The dirty region is copied to an internal staging buffer while the drawing
+ * lock is held; the bus transfer happens after the lock is released, so other
+ * tasks can keep drawing while the flush is on the wire.
+ *
+ * With async I2C (async_depth > 0) it returns once the frame is queued; a
+ * transfer error shows up in the next call or in ssd1306_wait_idle().
+ *
+ * When a transfer fails the panel is taken offline: drawing keeps working in
+ * RAM and flushes return at once until a retry is due (exponential backoff
+ * up to recover_max_ms). A retry resets and re-initializes the panel and
+ * sends this flush's region; the whole screen is marked dirty, so the next
+ * flush resends the rest.
+ *
+ * With lazy_init the first flush also sends the init sequence (and measures
+ * bus costs if not configured, which rewrites page 0; the next flush sends
+ * it again).
+ *
  * @param h Display handle.
- * @return ESP_OK on success.
+ * @return ESP_OK on success, ESP_ERR_TIMEOUT while the panel is offline, or
+ *         the bus error that took it offline.
  */
 esp_err_t ssd1306_display(ssd1306_handle_t h);
 
+/**
+ * @brief Wait until everything queued for the display has been sent.
+ *
+ * Returns at once for blocking transports. On a canvas, waits for each tile.
+ *
+ * @param h          Display handle.
+ * @param timeout_ms Maximum wait.
+ * @return ESP_OK when idle, ESP_ERR_TIMEOUT, or the error of a failed queued
+ *         transaction.
+ */
+esp_err_t ssd1306_wait_idle(ssd1306_handle_t h, uint32_t timeout_ms);
+
+/**
+ * @brief Get the bus cost parameters the flush planner uses.
+ *
+ * After a measurement at creation these can be saved and passed in
+ * ssd1306_config_t::bus_cost next time to skip it.
+ *
+ * @param h    Display handle.
+ * @param[out] out Cost parameters.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_get_bus_cost(ssd1306_handle_t h, ssd1306_bus_cost_t *out);
+
+/**
+ * @brief Seal the RTC store before deep sleep.
+ *
+ * Waits for queued transfers, then records a CRC over the framebuffer and
+ * the copy of the panel contents. Call it right before sleeping; anything
+ * drawn or flushed afterwards invalidates the store.
+ *
+ * On wakeup, creating the handle with the same rtc_store resumes with the
+ * previous framebuffer. Together with warm_attach the panel contents are
+ * known too: every flush is narrowed to the bytes that differ from them, so
+ * redrawing an unchanged screen sends nothing. Otherwise (or if the store is
+ * invalid) the first flush sends the whole screen.
+ *
+ * @param h Display handle created with rtc_store.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE without rtc_store, or the
+ *         error of a queued transfer (the store is then sealed without the
+ *         panel copy).
+ */
+esp_err_t ssd1306_rtc_save(ssd1306_handle_t h);
+
+/**
+ * @brief Report where a driver buffer was placed.
+ *
+ * @param h    Display handle.
+ * @param kind Buffer to query.
+ * @param[out] out Placement; size is 0 if the buffer is not allocated.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_get_buf_info(ssd1306_handle_t h, ssd1306_buf_kind_t kind,
+                               ssd1306_buf_info_t *out);
+
+/**
+ * @brief Change the bus sharing limits of a display.
+ *
+ * Waits for a flush in progress to finish.
+ *
+ * @param h    Display handle.
+ * @param fair New limits (all zero = none).
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_set_bus_fairness(ssd1306_handle_t          h,
+                                   const ssd1306_fairness_t *fair);
+
+/**
+ * @brief Strip render callback: draw the whole scene.
+ *
+ * Called once per page with drawing clipped to that page's 8 rows. Use the
+ * normal drawing API; anything outside the strip is dropped.
+ *
+ * @param h    Display handle.
+ * @param page Page (8-row strip) being rendered.
+ * @param arg  User argument.
+ */
+typedef void (*ssd1306_strip_cb_t)(ssd1306_handle_t h, int page, void *arg);
+
+/**
+ * @brief Render and send a frame strip by strip (strip mode only).
+ *
+ * For handles created with strip_buffers set, which hold one or two
+ * page-high strips (width bytes each) instead of a full framebuffer. For
+ * every page, the strip is cleared, cb draws the scene clipped to it, and the
+ * strip is sent. With two strips a sender task transmits one strip while the
+ * next is rendered. Drawing outside the callback has no effect.
+ *
+ * @param h   Display handle.
+ * @param cb  Render callback.
+ * @param arg User argument for cb.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not in strip mode.
+ */
+esp_err_t ssd1306_draw_strips(ssd1306_handle_t h, ssd1306_strip_cb_t cb,
+                              void *arg);
+
+/**
+ * @brief Send part of a frame within a time budget (incremental flush).
+ *
+ * For cooperative main loops that must not block for long. A step starts a
+ * new frame from a snapshot of the dirty region when none is in progress,
+ * then sends page rows, split into column chunks, until the next chunk would
+ * exceed budget_us. Chunk cost is estimated from the measured cost of
+ * previous chunks. At least one chunk is sent per call so the frame always
+ * progresses. Drawing between steps goes into the next frame; a call to
+ * ssd1306_display() in between sends what the step frame still had pending.
+ * Not available while the pipeline is running.
+ *
+ * @param h         Display handle.
+ * @param budget_us Time budget for this call.
+ * @param[out] more Optional; true if the frame is unfinished or newer
+ *                  drawing is waiting to be sent.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE with the pipeline running.
+ */
+esp_err_t ssd1306_display_step(ssd1306_handle_t h, uint32_t budget_us,
+                               bool *more);
+
+/**
+ * @brief Start the render queue and its render task.
+ *
+ * Once started, producers post commands with ssd1306_post() or
+ * ssd1306_post_from_isr() and the render task is the only one touching the
+ * framebuffer. Posting never blocks: it takes a bounded, lock-free slot in a
+ * multi-producer ring and wakes the render task.
+ *
+ * @param h   Display handle.
+ * @param cfg Queue configuration, or NULL for defaults.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already started.
+ */
+esp_err_t ssd1306_queue_start(ssd1306_handle_t h, const ssd1306_queue_cfg_t *cfg);
+
+/**
+ * @brief Stop the render task and free the queue.
+ *
+ * Commands still in the ring are discarded. Must not run concurrently with
+ * ssd1306_post() / ssd1306_post_from_isr(). Called by ssd1306_del().
+ *
+ * @param h Display handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_queue_stop(ssd1306_handle_t h);
+
+/**
+ * @brief Post a draw command to the render queue (task context).
+ *
+ * @param h   Display handle.
+ * @param cmd Command to copy into the ring.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the ring is full,
+ *         ESP_ERR_INVALID_STATE if the queue is not started.
+ */
+esp_err_t ssd1306_post(ssd1306_handle_t h, const ssd1306_cmd_t *cmd);
+
+/**
+ * @brief Post a draw command to the render queue from an ISR.
+ *
+ * @param h     Display handle.
+ * @param cmd   Command to copy into the ring.
+ * @param woken Set to pdTRUE if a context switch should be requested.
+ * @return Same as ssd1306_post().
+ */
+esp_err_t ssd1306_post_from_isr(ssd1306_handle_t h, const ssd1306_cmd_t *cmd,
+                                BaseType_t *woken);
+
+/**
+ * @brief Render/flush pipeline configuration.
+ */
+typedef struct {
+    BaseType_t  core_id;    /*!< Core the flush task is pinned to */
+    UBaseType_t priority;   /*!< Flush task priority (6 if 0) */
+    uint32_t    stack_size; /*!< Flush task stack size in bytes (3072 if 0) */
+} ssd1306_pipeline_cfg_t;
+
+/**
+ * @brief Start the render/flush pipeline.
+ *
+ * In pipeline mode ssd1306_display() only snapshots the dirty region into a
+ * back buffer and publishes it through a lock-free triple-buffer slot; a flush
+ * task pinned to another core transmits completed frames. Rendering on one
+ * core then overlaps with bus transfers on the other. If frames are produced
+ * faster than the bus can send them, only the latest is sent, covering the
+ * regions of the skipped ones (counted in stats.frames_merged).
+ *
+ * Needs three extra framebuffer-sized buffers. Flush errors are logged and
+ * the region is retried on the next ssd1306_display().
+ *
+ * @param h   Display handle.
+ * @param cfg Pipeline configuration, or NULL to pin the flush task to the core
+ *            the caller is not running on.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if already started.
+ */
+esp_err_t ssd1306_pipeline_start(ssd1306_handle_t              h,
+                                 const ssd1306_pipeline_cfg_t *cfg);
+
+/**
+ * @brief Stop the pipeline; ssd1306_display() transmits synchronously again.
+ *
+ * A frame published but not yet sent is kept as dirty. Must not run
+ * concurrently with ssd1306_display(). Called by ssd1306_del().
+ *
+ * @param h Display handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_pipeline_stop(ssd1306_handle_t h);
+
+/**
+ * @brief Create a display group.
+ *
+ * A group schedules flushes for several displays. Displays sharing a physical
+ * bus (same I2C port or SPI host) are flushed one after another by one
+ * scheduler task per bus, earliest deadline first and, among equally urgent
+ * requests, smallest dirty area first. Displays on different buses flush in
+ * parallel.
+ *
+ * @param[in]  cfg Group configuration, or NULL for defaults.
+ * @param[out] out Returned group handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_group_new(const ssd1306_group_cfg_t *cfg,
+                            ssd1306_group_handle_t    *out);
+
+/**
+ * @brief Add a display to a group.
+ *
+ * Add all displays before requesting flushes. The display must not use the
+ * pipeline (ssd1306_pipeline_start()) while in a group.
+ *
+ * @param g Group handle.
+ * @param h Display handle.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the group is full.
+ */
+esp_err_t ssd1306_group_add(ssd1306_group_handle_t g, ssd1306_handle_t h);
+
+/**
+ * @brief Request a flush of a display through its group.
+ *
+ * Returns immediately; the flush runs on the bus scheduler task. Requests for
+ * a display that is already pending are merged, keeping the earlier deadline.
+ *
+ * @param g           Group handle.
+ * @param h           Display handle.
+ * @param deadline_ms Time from now by which the flush should finish, or 0 for
+ *                    the group default.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if h is not in the group.
+ */
+esp_err_t ssd1306_group_request(ssd1306_group_handle_t g, ssd1306_handle_t h,
+                                uint32_t deadline_ms);
+
+/**
+ * @brief Read the group statistics of a display.
+ *
+ * @param g   Group handle.
+ * @param h   Display handle.
+ * @param out Returned statistics.
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if h is not in the group.
+ */
+esp_err_t ssd1306_group_get_stats(ssd1306_group_handle_t g, ssd1306_handle_t h,
+                                  ssd1306_group_stats_t *out);
+
+/**
+ * @brief Stop the group's scheduler tasks and free the group.
+ *
+ * Pending requests are dropped; the displays themselves are not deleted.
+ *
+ * @param g Group handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_group_del(ssd1306_group_handle_t g);
+
+/**
+ * @brief Read the runtime statistics of a display.
+ *
+ * @param h   Display handle.
+ * @param out Returned statistics.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_get_stats(ssd1306_handle_t h, ssd1306_stats_t *out);
+
+/**
+ * @brief Reset the runtime statistics of a display to zero.
+ *
+ * @param h Display handle.
+ * @return ESP_OK on success.
+ */
+esp_err_t ssd1306_reset_stats(ssd1306_handle_t h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,14 +8,18 @@
 
 #include "ssd1306.h"
 
+#include <driver/gpio.h>
 #include <driver/i2c_master.h>
 #include <driver/spi_master.h>
 #include <esp_err.h>
+#include <esp_rom_sys.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,9 +29,70 @@ extern "C" {
 typedef struct {
     esp_err_t (*send_cmd)(void *ctx, const uint8_t *cmd, size_t n);
     esp_err_t (*send_data)(void *ctx, const uint8_t *data, size_t n);
+    // Optional zero-copy send_data: data[-1] is writable and may be used for
+    // framing during the call; it is restored before returning.
+    esp_err_t (*send_data_inplace)(void *ctx, uint8_t *data, size_t n);
     esp_err_t (*reset)(void *ctx);
+    // Optional: hold the bus (e.g. a mux channel) across a whole flush
+    esp_err_t (*begin)(void *ctx);
+    esp_err_t (*end)(void *ctx); // reports failures of sends still queued
+    // Optional: false if talking to the device first needs a bus switch
+    bool (*selected)(void *ctx);
+    // Optional, for transports that queue: wait until all sends completed,
+    // returning the first error among them
+    esp_err_t (*wait_idle)(void *ctx, TickType_t timeout);
+    // Optional: get the bus usable again after failed transfers (before the
+    // panel is reset and re-initialized)
+    esp_err_t (*recover)(void *ctx);
 } ssd1306_bus_vt_t;
 
+// Inclusive pixel rectangle; empty when x0 > x1
+typedef struct {
+    int16_t x0, y0, x1, y1;
+} ssd1306_box_t;
+
+#define SSD1306_BOX_EMPTY ((ssd1306_box_t){INT16_MAX, INT16_MAX, -1, -1})
+
+static inline bool ssd1306_box_empty(const ssd1306_box_t *b) {
+    return b->x0 > b->x1 || b->y0 > b->y1;
+}
+
+static inline void ssd1306_box_union(ssd1306_box_t *dst,
+                                     const ssd1306_box_t *b) {
+    if (ssd1306_box_empty(b))
+        return;
+    if (ssd1306_box_empty(dst)) {
+        *dst = *b;
+        return;
+    }
+    if (b->x0 < dst->x0)
+        dst->x0 = b->x0;
+    if (b->y0 < dst->y0)
+        dst->y0 = b->y0;
+    if (b->x1 > dst->x1)
+        dst->x1 = b->x1;
+    if (b->y1 > dst->y1)
+        dst->y1 = b->y1;
+}
+
+// Render queue (ssd1306_queue.c)
+struct ssd1306_queue_t;
+
+// Render/flush pipeline (ssd1306_pipeline.c)
+struct ssd1306_pipe_t;
+
+// Virtual canvas tiles (ssd1306_canvas.c)
+struct ssd1306_canvas_t;
+
+// Strip mode sender task (ssd1306_core.c)
+struct ssd1306_strip_t;
+
+// RTC store header (ssd1306_core.c)
+struct ssd1306_rtc_t;
+
+// Controller descriptor (ssd1306_core.c)
+struct ssd1306_ctrl_t;
+
 // Struct representing physical SSD1306 display
 struct ssd1306_t {
     const ssd1306_font_t *font;
@@ -38,27 +103,178 @@ struct ssd1306_t {
     void                   *bus_ctx;
     const ssd1306_bus_vt_t *vt;
 
-    // Internal concurrency protection
-    SemaphoreHandle_t lock;
+    // Staging copy of the framebuffer that flushes transmit from, and the
+    // rows of a partial window packed together (NULL if unavailable). Both
+    // are used under flush_lock.
+    uint8_t *stage;
+    uint8_t *gather;
+
+    // Configured or measured at creation (transport defaults from bind); the
+    // flush planner weighs transactions against bytes
+    ssd1306_bus_cost_t cost;
+
+    // Controller, RAM column of fb column 0, and init sequence settings
+    // (replayed on recovery)
+    const struct ssd1306_ctrl_t *ctrl;
+    uint8_t                      col_off;
+    ssd1306_panel_cfg_t          panel;
+
+    // Buffer allocator and where each kind of buffer landed
+    ssd1306_alloc_cfg_t alloc;
+    ssd1306_buf_info_t  buf_info[SSD1306_BUF_COUNT];
+
+    // Internal concurrency protection. band_lock[0] guards the whole
+    // framebuffer unless lock_bands > 1 splits it into page bands.
+    SemaphoreHandle_t band_lock[SSD1306_MAX_LOCK_BANDS];
+    uint8_t           n_bands;
+    SemaphoreHandle_t flush_lock; // serializes bus transfers and stage use
+    portMUX_TYPE      spin;       // short critical sections (stats, dirty)
+    TickType_t        lock_timeout; // for band_lock, flush_lock from API calls
+
+    // Bus sharing limits for flushes; changed under flush_lock
+    ssd1306_fairness_t fair;
+
+    // Bus recovery: offline after a failed flush, retried from recover_at_us
+    // with doubling backoff_ms. Guarded by flush_lock.
+    uint32_t xfer_timeout_ms; // per transaction; read by bind
+    uint32_t recover_max_ms;
+    uint32_t backoff_ms;
+    int64_t  recover_at_us;
+    bool     offline;
+
+    // Lazy init: the init sequence (and cost measurement, if cost_pending)
+    // still has to run before the first flush. Guarded by flush_lock.
+    bool init_pending;
+    bool cost_pending;
+
+    // RTC store: fb and shadow live in it. The shadow is what the panel
+    // shows (valid if shadow_ok); snapshots skip bytes that match it.
+    // Written under flush_lock.
+    struct ssd1306_rtc_t *rtc;
+    uint8_t              *shadow;
+    bool                  shadow_ok;
+    bool                  rtc_resumed; // the store was sealed at creation
+
+    ssd1306_stats_t stats;
+
+    // Incremental flush (ssd1306_display_step): remaining region of the frame
+    // in stage, next column in its top page row, and chunk cost estimate.
+    // Guarded by flush_lock.
+    ssd1306_box_t step_box;
+    int16_t       step_x;
+    uint16_t      step_cost; // us per byte, Q8
+    uint32_t      step_us;   // bus time spent on the frame so far
+
+    // Optional render queue and flush pipeline
+    struct ssd1306_queue_t *queue;
+    struct ssd1306_pipe_t  *pipe;
+
+    // Set on a virtual canvas: flushes go to its tile displays
+    struct ssd1306_canvas_t *canvas;
+
+    // Rows drawing may touch and the page held in fb[0]. The whole screen
+    // normally; one strip at a time in strip mode (strip_bufs > 0).
+    int16_t                 clip_y0, clip_y1;
+    int16_t                 fb_page0;
+    uint8_t                 strip_bufs;
+    struct ssd1306_strip_t *strip; // sender task with two strips
 
     ssd1306_bus_t     bus;
+    uint32_t          bus_key; // identifies the physical bus (type, port/host)
     uint16_t          width;
     uint16_t          height;
-    uint16_t          dx0, dy0, dx1, dy1;
+    int16_t           dx0, dy0, dx1, dy1;
     bool              dirty;
     bool              driver_owns_fb;
+    bool              static_mem; // lives in an ssd1306_static_t, never freed
     bool              initialized;
 };
 
+// Bus contexts must fit the storage reserved for them
+#define SSD1306_STATIC_CTX_CHECK(type)                                         \
+    _Static_assert(sizeof(type) <= SSD1306_STATIC_BUS_CTX_SIZE,                \
+                   #type " exceeds SSD1306_STATIC_BUS_CTX_SIZE")
+
+// Bus context storage for bind: the preset d->bus_ctx for static handles,
+// zeroed, otherwise a new allocation.
+static inline void *ssd1306_ctx_alloc(struct ssd1306_t *d, size_t size) {
+    if (!d->static_mem)
+        return calloc(1, size);
+    memset(d->bus_ctx, 0, size);
+    return d->bus_ctx;
+}
+
+static inline void ssd1306_ctx_free(struct ssd1306_t *d, void *ctx) {
+    if (!d->static_mem)
+        free(ctx);
+}
+
+// Buffer allocation through the handle's allocator (ssd1306_core.c).
+// Zeroed; placement is recorded for ssd1306_get_buf_info(). Buffers that are
+// transmitted from (stage, pipeline slots, gather) get one byte of headroom.
+void *ssd1306_buf_alloc(struct ssd1306_t *d, ssd1306_buf_kind_t kind,
+                        size_t size);
+void  ssd1306_buf_free(struct ssd1306_t *d, ssd1306_buf_kind_t kind, void *ptr);
+// Record a caller-provided buffer
+void  ssd1306_buf_note(struct ssd1306_t *d, ssd1306_buf_kind_t kind,
+                       const void *ptr, size_t size);
+
+// Take mutex m within timeout ticks counted from start (portMAX_DELAY waits
+// forever), recording contended waits in the stats.
+bool ssd1306_take(struct ssd1306_t *d, SemaphoreHandle_t m, TickType_t timeout,
+                  TickType_t start);
+
+// Flush path (ssd1306_core.c)
+// Take the dirty region, widened by *box on entry, and copy it from fb into
+// dst (same layout as fb). Resets the dirty state. On return *box is the
+// region copied, possibly empty. Takes and releases the drawing lock.
+esp_err_t ssd1306_snapshot(struct ssd1306_t *d, uint8_t *dst,
+                           ssd1306_box_t *box);
+// Add a region to the dirty state (clipped; spinlock protected).
+void ssd1306_mark_dirty(struct ssd1306_t *d, int x0, int y0, int x1, int y1);
+// Transmit box from src (same layout as fb, with one byte of headroom in
+// front that the transport may borrow). On failure the region is marked dirty
+// again. Requires: the caller owns the bus for this display.
+esp_err_t ssd1306_send_rows(struct ssd1306_t *d, uint8_t *src,
+                            const ssd1306_box_t *box);
+
+// Dirty area in bytes (page rows x columns) waiting to be flushed
+size_t ssd1306_dirty_bytes(struct ssd1306_t *d);
+
+// Pipeline functions
+esp_err_t ssd1306_pipeline_submit(struct ssd1306_t *d);
+
+// Hardware reset: RES# low for at least 3 us, then the controller is ready
+// for commands within a few us (SSD1306 datasheet). Busy-waits with some
+// margin instead of sleeping for ticks.
+#define SSD1306_RST_LOW_US    10
+#define SSD1306_RST_SETTLE_US 10
+
+static inline void ssd1306_reset_pulse(gpio_num_t rst_gpio) {
+    gpio_set_level(rst_gpio, 0);
+    esp_rom_delay_us(SSD1306_RST_LOW_US);
+    gpio_set_level(rst_gpio, 1);
+    esp_rom_delay_us(SSD1306_RST_SETTLE_US);
+}
+
+// Bus identity used to group displays sharing a physical bus
+#define SSD1306_BUS_KEY(bus, port) (((uint32_t)(bus) << 8) | (uint8_t)(port))
+
 // I2C functions
-esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, i2c_port_num_t port,
-                           uint8_t addr, gpio_num_t rst_gpio);
+esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, const ssd1306_i2c_cfg_t *cfg);
 esp_err_t ssd1306_unbind_i2c(struct ssd1306_t *d);
 
+// Canvas functions
+esp_err_t ssd1306_bind_canvas(struct ssd1306_t           *d,
+                              const ssd1306_canvas_cfg_t *cfg);
+esp_err_t ssd1306_unbind_canvas(struct ssd1306_t *d);
+// Split box by tile and send each slice from src (canvas layout) to its
+// display. Requires: the caller holds the canvas flush_lock.
+esp_err_t ssd1306_canvas_send_rows(struct ssd1306_t *d, const uint8_t *src,
+                                   const ssd1306_box_t *box);
+
 // SPI functions
-esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, spi_host_device_t host,
-                           gpio_num_t cs_gpio, gpio_num_t dc_gpio,
-                           gpio_num_t rst_gpio, int clk_hz);
+esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, const ssd1306_spi_cfg_t *cfg);
 esp_err_t ssd1306_unbind_spi(struct ssd1306_t *d);
 
 #ifdef __cplusplus
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: MIT
+/*
+ * ssd1306_canvas.c - Virtual canvas tiled over several displays
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ */
+
+#include "ssd1306_private.h"
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#define CANVAS_WORKER_STACK 3072
+#define CANVAS_WORKER_PRIO  5
+
+static const char *TAG = "SSD1306_CANVAS";
+
+struct ssd1306_canvas_t;
+
+// Tiles sharing a physical bus are sent one after another by one task. The
+// first bus is driven by the flushing task itself, the others by workers.
+typedef struct {
+    struct ssd1306_canvas_t *c;
+    uint32_t                 key;
+    TaskHandle_t             task; // NULL for the first bus
+    esp_err_t                err;  // result of the last frame
+} canvas_bus_t;
+
+struct ssd1306_canvas_t {
+    struct ssd1306_t *owner; // the canvas handle
+    struct ssd1306_t *tile[SSD1306_CANVAS_MAX_TILES];
+    uint16_t          tx[SSD1306_CANVAS_MAX_TILES];
+    uint16_t          ty[SSD1306_CANVAS_MAX_TILES];
+    uint8_t           n_tiles;
+    canvas_bus_t      bus[SSD1306_CANVAS_MAX_TILES];
+    uint8_t           n_buses;
+    uint16_t          width; // canvas row stride
+
+    // Frame being sent; set before the workers are woken
+    const uint8_t    *src;
+    ssd1306_box_t     box;
+
+    SemaphoreHandle_t done; // given by a worker per frame and on exit
+    volatile bool     stop;
+};
+
+static esp_err_t canvas_wait_idle(void *ctx, TickType_t timeout);
+
+// No transport of its own: flushes are redirected to the tiles.
+static const ssd1306_bus_vt_t VT_CANVAS = {
+    .wait_idle = canvas_wait_idle,
+};
+
+// Wait for the tiles' queued sends. Tiles are only flushed through the
+// canvas, whose flush_lock the caller holds.
+static esp_err_t canvas_wait_idle(void *ctx, TickType_t timeout) {
+    struct ssd1306_canvas_t *c     = ctx;
+    const TickType_t         start = xTaskGetTickCount();
+    esp_err_t                ret   = ESP_OK;
+    for (int i = 0; i < c->n_tiles; ++i) {
+        struct ssd1306_t *t = c->tile[i];
+        if (!t->vt->wait_idle)
+            continue;
+        TickType_t left = timeout;
+        if (timeout != portMAX_DELAY) {
+            const TickType_t spent = xTaskGetTickCount() - start;
+            left                   = spent < timeout ? timeout - spent : 0;
+        }
+        esp_err_t e = t->vt->wait_idle(t->bus_ctx, left);
+        if (e != ESP_OK && ret == ESP_OK)
+            ret = e;
+    }
+    return ret;
+}
+
+// Copy the part of the frame that falls on tile i into the tile's staging
+// buffer (tile-local layout) and send it.
+static esp_err_t send_tile(struct ssd1306_canvas_t *c, int i) {
+    struct ssd1306_t *t = c->tile[i];
+    ssd1306_box_t     b = {
+        (int16_t)(c->box.x0 - c->tx[i]), (int16_t)(c->box.y0 - c->ty[i]),
+        (int16_t)(c->box.x1 - c->tx[i]), (int16_t)(c->box.y1 - c->ty[i])};
+    if (b.x0 < 0)
+        b.x0 = 0;
+    if (b.y0 < 0)
+        b.y0 = 0;
+    if (b.x1 >= (int)t->width)
+        b.x1 = (int16_t)(t->width - 1);
+    if (b.y1 >= (int)t->height)
+        b.y1 = (int16_t)(t->height - 1);
+    if (ssd1306_box_empty(&b))
+        return ESP_OK;
+
+    xSemaphoreTake(t->flush_lock, portMAX_DELAY);
+    const size_t bytes_wide = (size_t)(b.x1 - b.x0 + 1);
+    const int    page0      = c->ty[i] >> 3;
+    for (int p = b.y0 >> 3; p <= b.y1 >> 3; ++p) {
+        memcpy(&t->stage[(size_t)p * t->width + b.x0],
+               &c->src[(size_t)(page0 + p) * c->width + c->tx[i] + b.x0],
+               bytes_wide);
+    }
+    // The tile may be (re)initialized on the way, losing its RAM. Only this
+    // slice goes out now, so queue the rest of the tile on the canvas.
+    const bool fresh = t->offline || t->init_pending;
+    esp_err_t  err   = ssd1306_send_rows(t, t->stage, &b);
+    if (fresh && !t->offline && !t->init_pending)
+        ssd1306_mark_dirty(c->owner, c->tx[i], c->ty[i],
+                           c->tx[i] + t->width - 1, c->ty[i] + t->height - 1);
+    xSemaphoreGive(t->flush_lock);
+    return err;
+}
+
+static void send_bus(canvas_bus_t *bus) {
+    struct ssd1306_canvas_t *c = bus->c;
+    bus->err                   = ESP_OK;
+    for (int i = 0; i < c->n_tiles; ++i) {
+        if (c->tile[i]->bus_key != bus->key)
+            continue;
+        esp_err_t err = send_tile(c, i);
+        if (err != ESP_OK && bus->err == ESP_OK)
+            bus->err = err;
+    }
+}
+
+static void worker_task(void *arg) {
+    canvas_bus_t            *bus = arg;
+    struct ssd1306_canvas_t *c   = bus->c;
+
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (c->stop)
+            break;
+        send_bus(bus);
+        xSemaphoreGive(c->done);
+    }
+
+    xSemaphoreGive(c->done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t ssd1306_canvas_send_rows(struct ssd1306_t *d, const uint8_t *src,
+                                   const ssd1306_box_t *box) {
+    struct ssd1306_canvas_t *c = d->canvas;
+    c->src                     = src;
+    c->box                     = *box;
+
+    for (int i = 1; i < c->n_buses; ++i)
+        xTaskNotifyGive(c->bus[i].task);
+    send_bus(&c->bus[0]);
+    for (int i = 1; i < c->n_buses; ++i)
+        xSemaphoreTake(c->done, portMAX_DELAY);
+
+    for (int i = 0; i < c->n_buses; ++i) {
+        if (c->bus[i].err != ESP_OK)
+            return c->bus[i].err;
+    }
+    return ESP_OK;
+}
+
+// Stop the workers started so far and free the canvas (not the tiles).
+static void canvas_free(struct ssd1306_canvas_t *c) {
+    c->stop = true;
+    for (int i = 1; i < c->n_buses; ++i) {
+        if (c->bus[i].task) {
+            xTaskNotifyGive(c->bus[i].task);
+            xSemaphoreTake(c->done, portMAX_DELAY);
+        }
+    }
+    if (c->done)
+        vSemaphoreDelete(c->done);
+    free(c);
+}
+
+esp_err_t ssd1306_bind_canvas(struct ssd1306_t           *d,
+                              const ssd1306_canvas_cfg_t *cfg) {
+    ESP_RETURN_ON_FALSE(d && cfg && cfg->tiles, ESP_ERR_INVALID_ARG, TAG,
+                        "null arg");
+    ESP_RETURN_ON_FALSE(!d->strip_bufs, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "canvas in strip mode");
+    ESP_RETURN_ON_FALSE(cfg->n_tiles && cfg->n_tiles <= SSD1306_CANVAS_MAX_TILES,
+                        ESP_ERR_INVALID_ARG, TAG, "bad tile count %u",
+                        cfg->n_tiles);
+    for (int i = 0; i < cfg->n_tiles; ++i) {
+        const ssd1306_tile_t *t = &cfg->tiles[i];
+        ESP_RETURN_ON_FALSE(t->panel && t->panel->initialized &&
+                                t->panel->bus != SSD1306_CANVAS &&
+                                !t->panel->strip_bufs,
+                            ESP_ERR_INVALID_ARG, TAG, "tile %d: bad panel", i);
+        ESP_RETURN_ON_FALSE((t->y & 7) == 0 &&
+                                t->x + t->panel->width <= d->width &&
+                                t->y + t->panel->height <= d->height,
+                            ESP_ERR_INVALID_ARG, TAG,
+                            "tile %d: outside canvas or not page aligned", i);
+    }
+
+    struct ssd1306_canvas_t *c = calloc(1, sizeof(*c));
+    ESP_RETURN_ON_FALSE(c, ESP_ERR_NO_MEM, TAG, "no mem");
+    c->done = xSemaphoreCreateCounting(SSD1306_CANVAS_MAX_TILES, 0);
+    if (!c->done) {
+        free(c);
+        return ESP_ERR_NO_MEM;
+    }
+    c->owner   = d;
+    c->width   = d->width;
+    c->n_tiles = cfg->n_tiles;
+
+    for (int i = 0; i < c->n_tiles; ++i) {
+        c->tile[i] = cfg->tiles[i].panel;
+        c->tx[i]   = cfg->tiles[i].x;
+        c->ty[i]   = cfg->tiles[i].y;
+
+        const uint32_t key   = c->tile[i]->bus_key;
+        bool           known = false;
+        for (int b = 0; b < c->n_buses; ++b)
+            known = known || c->bus[b].key == key;
+        if (known)
+            continue;
+
+        canvas_bus_t *bus = &c->bus[c->n_buses++];
+        bus->c            = c;
+        bus->key          = key;
+        if (c->n_buses > 1 &&
+            xTaskCreate(worker_task, "ssd1306_canvas", CANVAS_WORKER_STACK,
+                        bus, CANVAS_WORKER_PRIO, &bus->task) != pdPASS) {
+            canvas_free(c);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    d->vt      = &VT_CANVAS;
+    d->bus_ctx = c;
+    d->canvas  = c;
+    d->bus     = SSD1306_CANVAS;
+    d->bus_key = SSD1306_BUS_KEY(SSD1306_CANVAS, 0);
+    ESP_LOGD(TAG, "%u tile(s) on %u bus(es)", c->n_tiles, c->n_buses);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_unbind_canvas(struct ssd1306_t *d) {
+    struct ssd1306_canvas_t *c = d ? d->canvas : NULL;
+    if (!c)
+        return ESP_OK;
+
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < c->n_tiles; ++i) {
+        esp_err_t e = ssd1306_del(c->tile[i]);
+        if (e != ESP_OK)
+            ret = e;
+    }
+    canvas_free(c);
+    d->canvas  = NULL;
+    d->bus_ctx = NULL;
+    d->vt      = NULL;
+    return ret;
+}
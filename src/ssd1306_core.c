@@ -10,13 +10,33 @@
 
 #include <esp_check.h>
 #include <esp_err.h>
+#include <esp_heap_caps.h>
 #include <esp_log.h>
-
-#define LOCK(d)           xSemaphoreTake((d)->lock, portMAX_DELAY)
-#define UNLOCK(d)         xSemaphoreGive((d)->lock)
+#include <esp_memory_utils.h>
+#include <esp_rom_crc.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+#include <freertos/queue.h>
+#include <string.h>
+
+#define LOCK(d)           lock_bands((d), LOCK_ALL, (d)->lock_timeout)
+#define UNLOCK(d)         unlock_bands((d), LOCK_ALL)
+#define LOCK_ALL          0xFFu
 #define FB_LEN(w, h)      ((size_t)(((w) * (h)) / 8))
 #define SSD1306_TEXT_HSPC 1
 #define SSD1306_TEXT_VSPC 2
+#define STEP_COST_INIT    (25 << 8) // us/byte, Q8: 400 kHz I2C
+#define STEP_OVERHEAD     8         // per-chunk cost in byte equivalents
+#define STEP_MIN_CHUNK    16        // columns
+#define STRIP_STACK       3072
+#define STRIP_PRIO        5
+#define STRIP_STOP        (-1)
+#define COPY_NS           10 // memcpy per byte in internal RAM, for planning
+#define CAL_REPS          3  // bus cost measurement runs, best one counts
+#define XFER_TIMEOUT_MS   100
+#define RECOVER_MIN_MS    10
+#define RECOVER_MAX_MS    5000
+#define RTC_MAGIC         0x13064654u
 
 static const char *TAG = "SSD1306";
 
@@ -27,56 +47,242 @@ static inline size_t fb_index(const struct ssd1306_t *d, int x, int page) {
     return (size_t)page * d->width + (size_t)x;
 }
 
-// Send select window command
+// ----- Bus sharing -----
+// Flush traffic goes out as transactions of at most fair.max_xfer_bytes with
+// a pause (or the yield callback) between them, so other devices sharing the
+// bus are never locked out for longer than one transaction.
+
+static void bus_pause(struct ssd1306_t *d) {
+    const ssd1306_fairness_t *f = &d->fair;
+    if (f->yield_cb) {
+        f->yield_cb(f->yield_arg);
+    } else if (f->gap_us >= portTICK_PERIOD_MS * 1000u) {
+        vTaskDelay((f->gap_us + portTICK_PERIOD_MS * 1000u - 1) /
+                   (portTICK_PERIOD_MS * 1000u));
+    } else if (f->gap_us) {
+        taskYIELD();
+        esp_rom_delay_us(f->gap_us);
+    }
+}
+
+// Send buf as command or data bytes. *gap is set once a transaction has gone
+// out and makes the next one pause first. With inplace, buf[-1] may be
+// borrowed by the transport to frame the data without copying.
+static esp_err_t bus_send(struct ssd1306_t *d, bool data, const uint8_t *buf,
+                          size_t n, bool inplace, bool *gap) {
+    inplace = inplace && data && d->vt->send_data_inplace;
+    const size_t max = d->fair.max_xfer_bytes ? d->fair.max_xfer_bytes : n;
+    esp_err_t    err = ESP_OK;
+    for (size_t off = 0; off < n && err == ESP_OK; off += max) {
+        const size_t blk = (n - off) < max ? (n - off) : max;
+        if (*gap)
+            bus_pause(d);
+
+        const int64_t t0 = esp_timer_get_time();
+        if (inplace)
+            err = d->vt->send_data_inplace(d->bus_ctx, (uint8_t *)&buf[off],
+                                           blk);
+        else if (data)
+            err = d->vt->send_data(d->bus_ctx, &buf[off], blk);
+        else
+            err = d->vt->send_cmd(d->bus_ctx, &buf[off], blk);
+        const uint32_t hold_us = (uint32_t)(esp_timer_get_time() - t0);
+        *gap                   = true;
+
+        portENTER_CRITICAL(&d->spin);
+        if (hold_us > d->stats.bus_hold_us_max)
+            d->stats.bus_hold_us_max = hold_us;
+        portEXIT_CRITICAL(&d->spin);
+    }
+    return err;
+}
+
+// ----- Controllers -----
+struct ssd1306_ctrl_t {
+    const char *name;
+    uint8_t     ram_cols; // columns of display RAM
+    uint8_t     pump_cmd; // charge pump / DC-DC command, 0 if none
+    uint8_t     pump_on;  // and its arguments
+    uint8_t     pump_off;
+    bool        windowed; // 0x21/0x22 windows with horizontal addressing
+};
+
+static const struct ssd1306_ctrl_t CTRLS[] = {
+    [SSD1306_CTRL_SSD1306] = {"SSD1306", 128, 0x8D, 0x14, 0x10, true},
+    [SSD1306_CTRL_SH1106]  = {"SH1106", 132, 0xAD, 0x8B, 0x8A, false},
+    [SSD1306_CTRL_SSD1309] = {"SSD1309", 128, 0x00, 0x00, 0x00, true},
+    [SSD1306_CTRL_SSD1305] = {"SSD1305", 132, 0x00, 0x00, 0x00, true},
+};
+
+_Static_assert(sizeof(CTRLS) / sizeof(CTRLS[0]) == SSD1306_CTRL_COUNT,
+               "a controller descriptor is missing");
+
+// Send select window command. Without windows (page addressing) only the
+// start of page p0 is set, and the column advances with each byte; callers
+// then send one page row at a time.
 static esp_err_t set_window(struct ssd1306_t *d, uint8_t x0, uint8_t x1,
-                            uint8_t p0, uint8_t p1) {
+                            uint8_t p0, uint8_t p1, bool *gap) {
+    const uint8_t c0 = (uint8_t)(x0 + d->col_off);
+    if (!d->ctrl->windowed) {
+        const uint8_t cmds[] = {
+            (uint8_t)(0xB0 | p0),        // PAGESTART
+            (uint8_t)(c0 & 0x0F),        // LOWCOLUMN
+            (uint8_t)(0x10 | (c0 >> 4)), // HIGHCOLUMN
+        };
+        return bus_send(d, false, cmds, sizeof(cmds), false, gap);
+    }
     const uint8_t cmds[] = {
         0x21,
-        (uint8_t)(x0),
-        (uint8_t)(x1), // COLUMNADDR
+        c0,
+        (uint8_t)(x1 + d->col_off), // COLUMNADDR
         0x22,
         p0,
         p1, // PAGEADDR
     };
-    return d->vt->send_cmd(d->bus_ctx, cmds, sizeof(cmds));
+    return bus_send(d, false, cmds, sizeof(cmds), false, gap);
 }
 
-static inline void dirty_reset(struct ssd1306_t *d) {
+// ----- Locking -----
+// The framebuffer is split into n_bands horizontal bands of whole pages, each
+// with its own mutex (one band unless lock_bands > 1). Callers lock the bands
+// their clipped rows touch; bands are always taken in ascending order.
+
+// Bitmask of the bands covering rows [y0..y1]
+static inline uint8_t band_mask(const struct ssd1306_t *d, int y0, int y1) {
+    if (d->n_bands <= 1)
+        return 1;
+    if (y0 < 0)
+        y0 = 0;
+    if (y1 >= (int)d->height)
+        y1 = (int)d->height - 1;
+    if (y0 > y1)
+        y0 = y1 = (y0 > 0) ? (int)d->height - 1 : 0;
+
+    const int pages = d->height >> 3;
+    const int b0    = (y0 >> 3) * d->n_bands / pages;
+    const int b1    = (y1 >> 3) * d->n_bands / pages;
+    return (uint8_t)(((1u << (b1 + 1)) - 1) & ~((1u << b0) - 1));
+}
+
+static void stats_lock_wait(struct ssd1306_t *d, uint32_t us, bool ok) {
+    portENTER_CRITICAL(&d->spin);
+    d->stats.lock_waits++;
+    d->stats.lock_wait_us_total += us;
+    if (us > d->stats.lock_wait_us_max)
+        d->stats.lock_wait_us_max = us;
+    if (!ok)
+        d->stats.lock_timeouts++;
+    portEXIT_CRITICAL(&d->spin);
+}
+
+bool ssd1306_take(struct ssd1306_t *d, SemaphoreHandle_t m, TickType_t timeout,
+                  TickType_t start) {
+    // Uncontended: no wait to account for.
+    if (xSemaphoreTake(m, 0) == pdTRUE)
+        return true;
+
+    if (timeout != portMAX_DELAY) {
+        const TickType_t spent = xTaskGetTickCount() - start;
+        timeout                = spent < timeout ? timeout - spent : 0;
+    }
+    const int64_t t0 = esp_timer_get_time();
+    const bool    ok = timeout && xSemaphoreTake(m, timeout) == pdTRUE;
+    stats_lock_wait(d, (uint32_t)(esp_timer_get_time() - t0), ok);
+    return ok;
+}
+
+static void unlock_bands(struct ssd1306_t *d, uint8_t mask) {
+    for (int b = d->n_bands - 1; b >= 0; --b) {
+        if (mask & (1u << b))
+            xSemaphoreGive(d->band_lock[b]);
+    }
+}
+
+// Take the bands in mask, giving up after timeout ticks in total.
+static esp_err_t lock_bands(struct ssd1306_t *d, uint8_t mask,
+                            TickType_t timeout) {
+    const TickType_t start = xTaskGetTickCount();
+    for (int b = 0; b < d->n_bands; ++b) {
+        if (!(mask & (1u << b)))
+            continue;
+        if (!ssd1306_take(d, d->band_lock[b], timeout, start)) {
+            unlock_bands(d, mask & ((1u << b) - 1));
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    return ESP_OK;
+}
+
+// Dirty state is shared by all bands; update it under the spinlock.
+// Move the dirty box into *box (union) and reset the dirty state.
+static inline void dirty_take(struct ssd1306_t *d, ssd1306_box_t *box) {
+    portENTER_CRITICAL(&d->spin);
+    if (d->dirty) {
+        ssd1306_box_union(box,
+                          &(ssd1306_box_t){d->dx0, d->dy0, d->dx1, d->dy1});
+    }
     d->dirty = false;
     d->dx0 = d->dy0 = INT16_MAX;
     d->dx1 = d->dy1 = -1;
+    portEXIT_CRITICAL(&d->spin);
 }
 
-// Mark bounding box as dirty
+// Mark bounding box as dirty (clipped to the screen)
 static inline void mark_dirty(struct ssd1306_t *d, int x0, int y0, int x1,
                               int y1) {
+    if (x0 < 0)
+        x0 = 0;
+    if (y0 < 0)
+        y0 = 0;
+    if (x1 >= (int)d->width)
+        x1 = (int)d->width - 1;
+    if (y1 >= (int)d->height)
+        y1 = (int)d->height - 1;
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    portENTER_CRITICAL(&d->spin);
     if (!d->dirty) {
         d->dirty = true;
         d->dx0   = x0;
         d->dy0   = y0;
         d->dx1   = x1;
         d->dy1   = y1;
-        return;
+    } else {
+        if (x0 < d->dx0)
+            d->dx0 = x0;
+        if (y0 < d->dy0)
+            d->dy0 = y0;
+        if (x1 > d->dx1)
+            d->dx1 = x1;
+        if (y1 > d->dy1)
+            d->dy1 = y1;
     }
-    if (x0 < d->dx0)
-        d->dx0 = x0;
-    if (y0 < d->dy0)
-        d->dy0 = y0;
-    if (x1 > d->dx1)
-        d->dx1 = x1;
-    if (y1 > d->dy1)
-        d->dy1 = y1;
+    portEXIT_CRITICAL(&d->spin);
+}
+
+void ssd1306_mark_dirty(struct ssd1306_t *d, int x0, int y0, int x1, int y1) {
+    mark_dirty(d, x0, y0, x1, y1);
+}
+
+size_t ssd1306_dirty_bytes(struct ssd1306_t *d) {
+    size_t n = 0;
+    portENTER_CRITICAL(&d->spin);
+    if (d->dirty)
+        n = (size_t)(d->dx1 - d->dx0 + 1) * ((d->dy1 >> 3) - (d->dy0 >> 3) + 1);
+    portEXIT_CRITICAL(&d->spin);
+    return n;
 }
 
 // Draw a pixel directly into framebuffer (no checks)
 // Preconditions:
 //   - d != NULL
 //   - 0 <= x < d->width
-//   - 0 <= y < d->height
+//   - d->clip_y0 <= y <= d->clip_y1
 //   - framebuffer allocated
 //   - device initialized
 static inline void draw_pixel_fast(struct ssd1306_t *d, int x, int y, bool on) {
-    const int     page = y >> 3; // 8 vertical pixels per byte
+    const int     page = (y >> 3) - d->fb_page0; // 8 vertical pixels per byte
     const uint8_t mask = (uint8_t)(1u << (y & 7));
     uint8_t      *byte = &d->fb[(page * d->width) + x];
 
@@ -91,7 +297,7 @@ static inline void draw_pixel_fast(struct ssd1306_t *d, int x, int y, bool on) {
 static inline void draw_hline_clipped(struct ssd1306_t *d, int x0, int x1,
                                       int y) {
     int w = (int)d->width;
-    if (y < 0 || y >= (int)d->height)
+    if (y < d->clip_y0 || y > d->clip_y1)
         return;
     if (x0 > x1) {
         int t = x0;
@@ -111,7 +317,7 @@ static inline void draw_hline_clipped(struct ssd1306_t *d, int x0, int x1,
 
 // Plot a pixel with bounds guard, lock is held.
 static inline void plot_if_visible(struct ssd1306_t *d, int x, int y) {
-    if ((unsigned)x < d->width && (unsigned)y < d->height)
+    if ((unsigned)x < d->width && y >= d->clip_y0 && y <= d->clip_y1)
         draw_pixel_fast(d, x, y, true);
 }
 
@@ -139,7 +345,7 @@ static inline void draw_glyph_scaled_nolock(struct ssd1306_t     *d,
                         continue;
                     for (int sy = 0; sy < scale; ++sy) {
                         const int py = base_y + sy;
-                        if ((unsigned)py >= d->height)
+                        if (py < d->clip_y0 || py > d->clip_y1)
                             continue;
                         draw_pixel_fast(d, px, py, on);
                     }
@@ -154,21 +360,50 @@ esp_err_t ssd1306_clear(ssd1306_handle_t h) {
     if (!d)
         return ESP_ERR_INVALID_STATE;
 
-    LOCK(d);
+    if (LOCK(d) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
         UNLOCK(d);
         return ESP_ERR_INVALID_STATE;
     }
-    memset(d->fb, 0, d->fb_len);
+    if (!d->strip_bufs) {
+        memset(d->fb, 0, d->fb_len);
+    } else if (d->clip_y0 <= d->clip_y1) {
+        // Only the strip being rendered; the other may be on the wire.
+        memset(&d->fb[fb_index(d, 0, (d->clip_y0 >> 3) - d->fb_page0)], 0,
+               d->width);
+    }
     mark_dirty(d, 0, 0, d->width - 1, d->height - 1);
 
     UNLOCK(d);
     return ESP_OK;
 }
 
+// Built-in panel profiles
+typedef struct {
+    bool    pump;      // internal charge pump on
+    uint8_t precharge; // 0xD9 argument
+    uint8_t vcomh;     // 0xDB argument
+    uint8_t contrast;  // 0x81 argument
+} panel_profile_t;
+
+static const panel_profile_t PANEL_PROFILES[] = {
+    [SSD1306_PANEL_INTERNAL_VCC] = {true, 0xF1, 0x40, 0x7F},
+    [SSD1306_PANEL_EXTERNAL_VCC] = {false, 0x22, 0x40, 0x9F},
+};
+
+_Static_assert(sizeof(PANEL_PROFILES) / sizeof(PANEL_PROFILES[0]) ==
+                   SSD1306_PANEL_COUNT,
+               "a panel profile is missing");
+
 // Send initialization sequence
 static esp_err_t run_init_sequence(struct ssd1306_t *d) {
-    uint8_t compins;
+    const ssd1306_panel_cfg_t *pc = &d->panel;
+    if (pc->init_cmds)
+        return d->vt->send_cmd(d->bus_ctx, pc->init_cmds, pc->init_len);
+
+    const panel_profile_t *pp = &PANEL_PROFILES[pc->profile];
+    uint8_t                compins;
     switch (d->height) {
     case 16:
     case 32:
@@ -182,27 +417,93 @@ static esp_err_t run_init_sequence(struct ssd1306_t *d) {
         compins = 0x12;
         break;
     }
-
-    const uint8_t init[] = {
-        0xAE,       // DISPLAYOFF
-        0x20, 0x00, // MEMORYMODE: horizontal
+    if (pc->com_pins)
+        compins = pc->com_pins;
+    const uint8_t contrast  = pc->contrast ? pc->contrast : pp->contrast;
+    const uint8_t clock_div = pc->clock_div ? pc->clock_div : 0x80;
+    const uint8_t precharge = pc->precharge ? pc->precharge : pp->precharge;
+    const uint8_t vcomh     = pc->vcomh ? pc->vcomh : pp->vcomh;
+
+    const uint8_t common[] = {
+        0xAE, // DISPLAYOFF
         0xA8, (uint8_t)(d->height - 1),
-        0xD3, 0x00,    // DISPLAYOFFSET = 0
-        0x40,          // STARTLINE(0)
-        0xA1,          // SEGREMAP
-        0xC8,          // COMSCANDEC
-        0xDA, compins, // COMPINS
-        0x81, 0x7F,    // CONTRAST
-        0xA4,          // RESUME display
-        0xA6,          // NORMALDISPLAY
-        0xD5, 0x80,    // CLOCKDIV
-        0xD9, 0xF1,    // PRECHARGE (0x22 for external VCC)
-        0xDB, 0x40,    // VCOMDETECT
-        0x8D, 0x14,    // CHARGEPUMP ON (0x10 for external VCC)
-        0xAF           // DISPLAYON
+        0xD3, 0x00,      // DISPLAYOFFSET = 0
+        0x40,            // STARTLINE(0)
+        0xA1,            // SEGREMAP
+        0xC8,            // COMSCANDEC
+        0xDA, compins,   // COMPINS
+        0x81, contrast,  // CONTRAST
+        0xA4,            // RESUME display
+        0xA6,            // NORMALDISPLAY
+        0xD5, clock_div, // CLOCKDIV
+        0xD9, precharge, // PRECHARGE
+        0xDB, vcomh,     // VCOMDETECT
     };
 
-    return d->vt->send_cmd(d->bus_ctx, init, sizeof(init));
+    // Controller specific: addressing mode and charge pump
+    const struct ssd1306_ctrl_t *ct = d->ctrl;
+    uint8_t                      init[sizeof(common) + 5];
+    size_t                       n = sizeof(common);
+    memcpy(init, common, n);
+    if (ct->windowed) {
+        init[n++] = 0x20; // MEMORYMODE: horizontal (else page addressing)
+        init[n++] = 0x00;
+    }
+    if (ct->pump_cmd) {
+        init[n++] = ct->pump_cmd; // CHARGEPUMP / DC-DC
+        init[n++] = pp->pump ? ct->pump_on : ct->pump_off;
+    }
+    init[n++] = 0xAF; // DISPLAYON
+
+    return d->vt->send_cmd(d->bus_ctx, init, n);
+}
+
+// RAM column of fb column 0: configured, or by default panels centered in
+// wider RAM. Requires: a valid controller and col_offset.
+static uint8_t ctrl_col_off(const ssd1306_config_t *cfg) {
+    const struct ssd1306_ctrl_t *ct = &CTRLS[cfg->controller];
+    if (cfg->col_offset != SSD1306_COL_OFFSET_AUTO)
+        return (uint8_t)cfg->col_offset;
+    if (ct->ram_cols <= 128 || cfg->width > ct->ram_cols)
+        return 0;
+    return (uint8_t)((ct->ram_cols - cfg->width) / 2);
+}
+
+// Controller and panel settings: the panel fits the controller's RAM, a
+// command table or overrides, and only values the controller defines
+static esp_err_t validate_panel(const ssd1306_config_t *cfg) {
+    const ssd1306_panel_cfg_t   *pc = &cfg->panel;
+    const struct ssd1306_ctrl_t *ct = &CTRLS[cfg->controller];
+    ESP_RETURN_ON_FALSE(cfg->col_offset >= SSD1306_COL_OFFSET_AUTO &&
+                            cfg->col_offset < ct->ram_cols,
+                        ESP_ERR_INVALID_ARG, TAG, "bad col_offset");
+    ESP_RETURN_ON_FALSE(cfg->width + ctrl_col_off(cfg) <= ct->ram_cols,
+                        ESP_ERR_INVALID_ARG, TAG, "%s has %u columns",
+                        ct->name, ct->ram_cols);
+    ESP_RETURN_ON_FALSE((unsigned)pc->profile < SSD1306_PANEL_COUNT,
+                        ESP_ERR_INVALID_ARG, TAG, "unknown panel profile");
+    if (pc->init_cmds || pc->init_len) {
+        ESP_RETURN_ON_FALSE(pc->init_cmds && pc->init_len, ESP_ERR_INVALID_ARG,
+                            TAG, "init_cmds needs init_len");
+        ESP_RETURN_ON_FALSE(!pc->clock_div && !pc->precharge && !pc->vcomh &&
+                                !pc->contrast && !pc->com_pins,
+                            ESP_ERR_INVALID_ARG, TAG,
+                            "init_cmds excludes panel overrides");
+        return ESP_OK;
+    }
+    // Multiplex ratio 16..64
+    ESP_RETURN_ON_FALSE(cfg->height >= 16 && cfg->height <= 64,
+                        ESP_ERR_INVALID_ARG, TAG, "height %u unsupported",
+                        cfg->height);
+    ESP_RETURN_ON_FALSE(!pc->precharge ||
+                            ((pc->precharge & 0x0F) && (pc->precharge >> 4)),
+                        ESP_ERR_INVALID_ARG, TAG, "precharge phase of 0");
+    ESP_RETURN_ON_FALSE(!(pc->vcomh & 0x8F), ESP_ERR_INVALID_ARG, TAG,
+                        "bad vcomh 0x%02x", pc->vcomh);
+    ESP_RETURN_ON_FALSE(!pc->com_pins || (pc->com_pins & 0xCF) == 0x02,
+                        ESP_ERR_INVALID_ARG, TAG, "bad com_pins 0x%02x",
+                        pc->com_pins);
+    return ESP_OK;
 }
 
 // Basic validation for config
@@ -211,38 +512,338 @@ static esp_err_t validate_cfg(const ssd1306_config_t *cfg) {
         return ESP_ERR_INVALID_ARG;
     if (!cfg->width || !cfg->height)
         return ESP_ERR_INVALID_ARG;
-    if (cfg->fb && cfg->fb_len != FB_LEN(cfg->width, cfg->height))
+    if (cfg->strip_buffers > 2)
+        return ESP_ERR_INVALID_ARG;
+    const size_t fb_len = cfg->strip_buffers
+                              ? (size_t)cfg->width * cfg->strip_buffers
+                              : FB_LEN(cfg->width, cfg->height);
+    if (cfg->fb && cfg->fb_len != fb_len)
         return ESP_ERR_INVALID_SIZE;
+    if (cfg->lock_bands > SSD1306_MAX_LOCK_BANDS ||
+        cfg->lock_bands > (cfg->height >> 3))
+        return ESP_ERR_INVALID_ARG;
+    if (cfg->rtc_store && (cfg->fb || cfg->strip_buffers ||
+                           cfg->bus == SSD1306_CANVAS))
+        return ESP_ERR_INVALID_ARG;
+    if ((unsigned)cfg->controller >= SSD1306_CTRL_COUNT)
+        return ESP_ERR_INVALID_ARG;
+    return cfg->bus == SSD1306_CANVAS ? ESP_OK : validate_panel(cfg);
+}
+
+// ----- Buffers -----
+
+// No driver buffer is cold today, so cold_in_psram changes nothing yet. The
+// queue ring is written by ssd1306_post_from_isr() and must stay internal.
+static uint32_t buf_caps(const struct ssd1306_t *d, ssd1306_buf_kind_t kind) {
+    if (kind == SSD1306_BUF_QUEUE)
+        return MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+    return MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+}
+
+void ssd1306_buf_note(struct ssd1306_t *d, ssd1306_buf_kind_t kind,
+                      const void *ptr, size_t size) {
+    ssd1306_buf_info_t *bi       = &d->buf_info[kind];
+    const bool          internal = esp_ptr_internal(ptr);
+    const bool          dma      = esp_ptr_dma_capable(ptr);
+    if (!bi->size) {
+        *bi = (ssd1306_buf_info_t){ptr, size, internal, dma};
+    } else {
+        // Multi-slot buffer: report the worst placement
+        bi->size += size;
+        bi->internal = bi->internal && internal;
+        bi->dma      = bi->dma && dma;
+    }
+    ESP_LOGD(TAG, "buf %d: %u bytes at %p (%s%s)", kind, (unsigned)size, ptr,
+             internal ? "internal" : "external", dma ? ", DMA" : "");
+}
+
+// Bytes reserved in front of a buffer for in-place transport framing
+static inline size_t buf_headroom(ssd1306_buf_kind_t kind) {
+    return (kind == SSD1306_BUF_STAGE || kind == SSD1306_BUF_PIPE ||
+            kind == SSD1306_BUF_GATHER)
+               ? 1
+               : 0;
+}
+
+void *ssd1306_buf_alloc(struct ssd1306_t *d, ssd1306_buf_kind_t kind,
+                        size_t size) {
+    const uint32_t caps = buf_caps(d, kind);
+    const size_t   hr   = buf_headroom(kind);
+    uint8_t       *p;
+    if (d->alloc.alloc) {
+        p = d->alloc.alloc(kind, size + hr, caps, d->alloc.arg);
+    } else {
+        p = heap_caps_calloc(1, size + hr, caps);
+        if (!p && kind != SSD1306_BUF_QUEUE) {
+            ESP_LOGW(TAG, "buf %d: no memory with caps 0x%lx, using default",
+                     kind, (unsigned long)caps);
+            p = heap_caps_calloc(1, size + hr, MALLOC_CAP_DEFAULT);
+        }
+    }
+    if (!p)
+        return NULL;
+    ssd1306_buf_note(d, kind, p + hr, size);
+    return p + hr;
+}
+
+void ssd1306_buf_free(struct ssd1306_t *d, ssd1306_buf_kind_t kind,
+                      void *ptr) {
+    if (!ptr)
+        return;
+    ptr = (uint8_t *)ptr - buf_headroom(kind);
+    if (d->alloc.alloc)
+        d->alloc.free(kind, ptr, d->alloc.arg);
+    else
+        heap_caps_free(ptr);
+    d->buf_info[kind] = (ssd1306_buf_info_t){0};
+}
+
+_Static_assert(sizeof(struct ssd1306_t) <= SSD1306_STATIC_HANDLE_SIZE,
+               "struct ssd1306_t exceeds SSD1306_STATIC_HANDLE_SIZE");
+
+static SemaphoreHandle_t new_mutex(ssd1306_static_t *mem, int i) {
+    return mem ? xSemaphoreCreateMutexStatic(&mem->locks[i])
+               : xSemaphoreCreateMutex();
+}
+
+// ----- Strip mode -----
+// fb holds one or two page-high strips. With two, a sender task transmits
+// one strip while the caller renders the next; strips are handed over
+// through a queue and returned through a counting semaphore.
+struct ssd1306_strip_t {
+    QueueHandle_t     todo; // (page << 1) | strip index, or STRIP_STOP
+    SemaphoreHandle_t idle; // strips free for rendering
+    TaskHandle_t      task;
+    esp_err_t         err;  // first send error of the frame
+};
+
+static esp_err_t send_strip(struct ssd1306_t *d, const uint8_t *src,
+                            int page) {
+    bool       gap  = false;
+    esp_err_t  err  = d->vt->begin ? d->vt->begin(d->bus_ctx) : ESP_OK;
+    const bool held = err == ESP_OK;
+    if (err == ESP_OK)
+        err = set_window(d, 0, (uint8_t)(d->width - 1), (uint8_t)page,
+                         (uint8_t)page, &gap);
+    if (err == ESP_OK)
+        err = bus_send(d, true, src, d->width, false, &gap); // fb is live
+    if (held && d->vt->end) {
+        const esp_err_t e = d->vt->end(d->bus_ctx);
+        if (err == ESP_OK)
+            err = e;
+    }
+    return err;
+}
+
+static void strip_task(void *arg) {
+    struct ssd1306_t       *d = arg;
+    struct ssd1306_strip_t *s = d->strip;
+    int                     item;
+
+    while (xQueueReceive(s->todo, &item, portMAX_DELAY) == pdTRUE &&
+           item != STRIP_STOP) {
+        esp_err_t err = send_strip(d, &d->fb[(item & 1) * d->width], item >> 1);
+        if (err != ESP_OK && s->err == ESP_OK)
+            s->err = err;
+        xSemaphoreGive(s->idle);
+    }
+
+    xSemaphoreGive(s->idle); // acknowledge STRIP_STOP
+    vTaskDelete(NULL);
+}
+
+static void strip_free(struct ssd1306_strip_t *s) {
+    if (s->todo)
+        vQueueDelete(s->todo);
+    if (s->idle)
+        vSemaphoreDelete(s->idle);
+    free(s);
+}
+
+static esp_err_t strip_start(struct ssd1306_t *d) {
+    struct ssd1306_strip_t *s = calloc(1, sizeof(*s));
+    if (!s)
+        return ESP_ERR_NO_MEM;
+    s->todo = xQueueCreate(2, sizeof(int));
+    s->idle = xSemaphoreCreateCounting(2, 2);
+    d->strip = s;
+    if (!s->todo || !s->idle ||
+        xTaskCreate(strip_task, "ssd1306_strip", STRIP_STACK, d, STRIP_PRIO,
+                    &s->task) != pdPASS) {
+        d->strip = NULL;
+        strip_free(s);
+        return ESP_ERR_NO_MEM;
+    }
     return ESP_OK;
 }
 
-// Common creation for ssd1306_handle_t
-static esp_err_t new_common(const ssd1306_config_t *cfg, ssd1306_handle_t *out,
-                            struct ssd1306_t **dev_out) {
+static void strip_stop(struct ssd1306_t *d) {
+    struct ssd1306_strip_t *s = d->strip;
+    if (!s)
+        return;
+    // Both strips idle means nothing is queued; then stop the task.
+    xSemaphoreTake(s->idle, portMAX_DELAY);
+    xSemaphoreTake(s->idle, portMAX_DELAY);
+    const int stop = STRIP_STOP;
+    xQueueSend(s->todo, &stop, portMAX_DELAY);
+    xSemaphoreTake(s->idle, portMAX_DELAY);
+    d->strip = NULL;
+    strip_free(s);
+}
+
+// ----- RTC store -----
+// Header, then fb, then the shadow (what the panel shows). Sealed with a CRC
+// by ssd1306_rtc_save(); unsealed again as soon as it is in use.
+struct ssd1306_rtc_t {
+    uint32_t magic;
+    uint16_t width, height;
+    uint8_t  shadow_ok;
+    uint8_t  reserved[3];
+    uint32_t crc; // over the header up to here, fb and shadow
+    uint8_t  data[];
+};
+
+_Static_assert(sizeof(struct ssd1306_rtc_t) == 4 * sizeof(uint32_t),
+               "SSD1306_RTC_STORE_WORDS() assumes a 4-word header");
+
+static uint32_t rtc_crc(const struct ssd1306_rtc_t *r, size_t fb_len) {
+    const uint32_t crc = esp_rom_crc32_le(
+        0, (const uint8_t *)r, offsetof(struct ssd1306_rtc_t, crc));
+    return esp_rom_crc32_le(crc, r->data, (uint32_t)(2 * fb_len));
+}
+
+// Take fb and shadow from the store. A sealed store of the same geometry
+// resumes; anything else starts blank.
+static void rtc_attach(struct ssd1306_t *d, uint32_t *store) {
+    struct ssd1306_rtc_t *r      = (struct ssd1306_rtc_t *)store;
+    const size_t          fb_len = FB_LEN(d->width, d->height);
+    bool sealed = r->magic == RTC_MAGIC && r->width == d->width &&
+                  r->height == d->height;
+    sealed      = sealed && r->crc == rtc_crc(r, fb_len);
+    if (!sealed) {
+        memset(r, 0, sizeof(*r) + 2 * fb_len);
+        r->magic  = RTC_MAGIC;
+        r->width  = d->width;
+        r->height = d->height;
+    }
+    d->shadow_ok   = sealed && r->shadow_ok;
+    d->rtc_resumed = sealed;
+    r->crc         = 0; // a reset before the next save must not resume
+
+    d->rtc    = r;
+    d->fb     = r->data;
+    d->shadow = &r->data[fb_len];
+    ESP_LOGD(TAG, "RTC store %s", sealed ? "resumed" : "initialized");
+}
+
+// Common creation for ssd1306_handle_t. With mem, everything comes from the
+// caller's storage and the heap is not touched.
+static esp_err_t new_common(const ssd1306_config_t *cfg, ssd1306_static_t *mem,
+                            ssd1306_handle_t *out, struct ssd1306_t **dev_out) {
     ESP_RETURN_ON_FALSE(out, ESP_ERR_INVALID_ARG, TAG, "out=NULL");
     ESP_RETURN_ON_ERROR(validate_cfg(cfg), TAG, "bad cfg");
-
-    struct ssd1306_t *d = calloc(1, sizeof(*d));
+    ESP_RETURN_ON_FALSE(
+        !mem || ((cfg->fb || cfg->rtc_store) &&
+                 (mem->stage || cfg->strip_buffers == 1)),
+        ESP_ERR_INVALID_ARG, TAG, "static handle needs fb and stage");
+    ESP_RETURN_ON_FALSE(!mem || cfg->strip_buffers < 2, ESP_ERR_INVALID_ARG,
+                        TAG, "double strips need a sender task");
+    ESP_RETURN_ON_FALSE(!cfg->alloc.alloc == !cfg->alloc.free,
+                        ESP_ERR_INVALID_ARG, TAG, "alloc needs free");
+
+    struct ssd1306_t *d =
+        mem ? memset(mem->handle, 0, sizeof(*d)) : calloc(1, sizeof(*d));
     ESP_RETURN_ON_FALSE(d, ESP_ERR_NO_MEM, TAG, "no memory");
+    if (mem) {
+        d->static_mem = true;
+        d->bus_ctx    = mem->bus_ctx; // storage for bind
+    }
 
     d->width  = cfg->width;
     d->height = cfg->height;
-
-    d->fb_len = cfg->fb ? cfg->fb_len : FB_LEN(cfg->width, cfg->height);
-    d->fb     = cfg->fb ? cfg->fb : calloc(1, d->fb_len);
+    d->alloc  = cfg->alloc;
+    d->cost   = cfg->bus_cost; // bind fills in defaults if unset
+    d->panel  = cfg->panel;
+
+    d->ctrl    = &CTRLS[cfg->controller];
+    d->col_off = ctrl_col_off(cfg);
+    d->xfer_timeout_ms =
+        cfg->xfer_timeout_ms ? cfg->xfer_timeout_ms : XFER_TIMEOUT_MS;
+    d->recover_max_ms =
+        cfg->recover_max_ms ? cfg->recover_max_ms : RECOVER_MAX_MS;
+
+    d->strip_bufs = cfg->strip_buffers;
+    d->fb_len     = cfg->fb             ? cfg->fb_len
+                    : d->strip_bufs ? (size_t)d->width * d->strip_bufs
+                                    : FB_LEN(cfg->width, cfg->height);
+    if (cfg->rtc_store) {
+        rtc_attach(d, cfg->rtc_store);
+        ssd1306_buf_note(d, SSD1306_BUF_FB, d->fb, d->fb_len);
+    } else {
+        d->fb = cfg->fb ? cfg->fb
+                        : ssd1306_buf_alloc(d, SSD1306_BUF_FB, d->fb_len);
+    }
     if (!d->fb) {
         free(d);
         return ESP_ERR_NO_MEM;
     }
+    // Drawn only through the API, so dirty tracking holds for the store too.
     d->driver_owns_fb = (cfg->fb == NULL);
-
-    d->lock           = xSemaphoreCreateMutex();
-    if (!d->lock) {
-        if (d->driver_owns_fb)
-            free(d->fb);
+    if (cfg->fb)
+        ssd1306_buf_note(d, SSD1306_BUF_FB, cfg->fb, cfg->fb_len);
+
+    // Strips are sent straight from fb; no staging buffer. A static stage
+    // starts with the headroom byte.
+    if (mem && mem->stage)
+        ssd1306_buf_note(d, SSD1306_BUF_STAGE, mem->stage + 1, d->fb_len);
+    d->stage = mem            ? (mem->stage ? mem->stage + 1 : NULL)
+               : d->strip_bufs ? NULL
+                               : ssd1306_buf_alloc(d, SSD1306_BUF_STAGE,
+                                                   d->fb_len);
+    // Optional: without it partial flushes go page by page or widen. Strips
+    // are full width, a canvas flushes through its tiles, and with page
+    // addressing rows cannot be packed.
+    if (mem && mem->gather) {
+        d->gather = mem->gather + 1;
+        ssd1306_buf_note(d, SSD1306_BUF_GATHER, d->gather, d->fb_len);
+    } else if (!mem && !d->strip_bufs && cfg->bus != SSD1306_CANVAS &&
+               d->ctrl->windowed) {
+        d->gather = ssd1306_buf_alloc(d, SSD1306_BUF_GATHER, d->fb_len);
+        if (!d->gather)
+            ESP_LOGW(TAG, "no gather buffer, partial flushes send per page");
+    }
+    d->flush_lock     = new_mutex(mem, 0);
+    d->n_bands        = cfg->lock_bands ? cfg->lock_bands : 1;
+    bool locks_ok     = true;
+    for (int b = 0; b < d->n_bands; ++b) {
+        d->band_lock[b] = new_mutex(mem, 1 + b);
+        locks_ok        = locks_ok && d->band_lock[b];
+    }
+    if ((!d->stage && !d->strip_bufs) || !d->flush_lock || !locks_ok ||
+        (d->strip_bufs == 2 && strip_start(d) != ESP_OK)) {
+        // Static creation cannot fail here.
+        if (d->flush_lock)
+            vSemaphoreDelete(d->flush_lock);
+        for (int b = 0; b < d->n_bands; ++b) {
+            if (d->band_lock[b])
+                vSemaphoreDelete(d->band_lock[b]);
+        }
+        ssd1306_buf_free(d, SSD1306_BUF_STAGE, d->stage);
+        ssd1306_buf_free(d, SSD1306_BUF_GATHER, d->gather);
+        if (d->driver_owns_fb && !d->rtc)
+            ssd1306_buf_free(d, SSD1306_BUF_FB, d->fb);
         free(d);
         return ESP_ERR_NO_MEM;
     }
+    portMUX_INITIALIZE(&d->spin);
+    d->lock_timeout = cfg->lock_timeout_ms ? pdMS_TO_TICKS(cfg->lock_timeout_ms)
+                                           : portMAX_DELAY;
+    d->fair         = cfg->fairness;
+    d->step_box     = SSD1306_BOX_EMPTY;
+    d->step_cost    = STEP_COST_INIT;
+    // Outside ssd1306_draw_strips() strip mode has no rows to draw into.
+    d->clip_y0      = d->strip_bufs ? 1 : 0;
+    d->clip_y1      = d->strip_bufs ? 0 : (int16_t)(d->height - 1);
 
     d->font = &ssd1306_font5x7;
 
@@ -252,35 +853,179 @@ static esp_err_t new_common(const ssd1306_config_t *cfg, ssd1306_handle_t *out,
     return ESP_OK;
 }
 
-// ----- Public API -----
-esp_err_t ssd1306_new_i2c(const ssd1306_config_t *cfg, ssd1306_handle_t *out) {
-    struct ssd1306_t *d = NULL;
-    ESP_RETURN_ON_ERROR(new_common(cfg, out, &d), TAG, "alloc");
+// Queuing transports: the measurement times transfers, not queuing
+static inline esp_err_t wait_sent(struct ssd1306_t *d) {
+    return d->vt->wait_idle ? d->vt->wait_idle(d->bus_ctx, portMAX_DELAY)
+                            : ESP_OK;
+}
+
+// Measure the bus costs by rewriting page 0 from src (fb layout, with
+// headroom): time set_window, a full row and a single byte (the column
+// pointer has wrapped back to 0, so the byte lands where it already is; with
+// page addressing it lands past the panel's columns), best of CAL_REPS.
+// Leaves the transport defaults in place if anything fails.
+static void measure_cost(struct ssd1306_t *d, uint8_t *src) {
+
+    // Fairness pauses are accounted separately by the planner.
+    const ssd1306_fairness_t fair = d->fair;
+    memset(&d->fair, 0, sizeof(d->fair));
+
+    const uint8_t last  = (uint8_t)(d->width - 1);
+    int64_t       t_cmd = INT64_MAX, t_row = INT64_MAX, t_one = INT64_MAX;
+    bool          gap   = false;
+    esp_err_t     err   = d->vt->begin ? d->vt->begin(d->bus_ctx) : ESP_OK;
+    const bool    held  = err == ESP_OK;
+    for (int i = 0; i < CAL_REPS && err == ESP_OK; ++i) {
+        const int64_t t0 = esp_timer_get_time();
+        err              = set_window(d, 0, last, 0, 0, &gap);
+        if (err == ESP_OK)
+            err = wait_sent(d);
+        const int64_t t1 = esp_timer_get_time();
+        if (err == ESP_OK)
+            err = bus_send(d, true, src, d->width, true, &gap);
+        if (err == ESP_OK)
+            err = wait_sent(d);
+        const int64_t t2 = esp_timer_get_time();
+        if (err == ESP_OK)
+            err = bus_send(d, true, src, 1, true, &gap);
+        if (err == ESP_OK)
+            err = wait_sent(d);
+        const int64_t t3 = esp_timer_get_time();
+        if (t1 - t0 < t_cmd)
+            t_cmd = t1 - t0;
+        if (t2 - t1 < t_row)
+            t_row = t2 - t1;
+        if (t3 - t2 < t_one)
+            t_one = t3 - t2;
+    }
+    if (held && d->vt->end) {
+        const esp_err_t e = d->vt->end(d->bus_ctx);
+        if (err == ESP_OK)
+            err = e;
+    }
+    d->fair = fair;
+
+    if (err != ESP_OK || d->width < 2) {
+        ESP_LOGW(TAG, "bus cost measurement failed, using defaults");
+        return;
+    }
+    const int64_t byte_ns  = (t_row - t_one) * 1000 / (d->width - 1);
+    const int64_t setup_ns = t_one * 1000 - byte_ns;
+    d->cost.byte_ns        = byte_ns > 0 ? (uint32_t)byte_ns : 1;
+    d->cost.setup_ns       = setup_ns > 0 ? (uint32_t)setup_ns : 0;
+    d->cost.cmd_ns         = (uint32_t)(t_cmd * 1000);
+    ESP_LOGI(TAG, "bus cost: setup %lu ns, %lu ns/byte, window %lu ns",
+             (unsigned long)d->cost.setup_ns, (unsigned long)d->cost.byte_ns,
+             (unsigned long)d->cost.cmd_ns);
+}
 
-    ESP_RETURN_ON_ERROR(ssd1306_bind_i2c(d, cfg->iface.i2c.port,
-                                         cfg->iface.i2c.addr,
-                                         cfg->iface.i2c.rst_gpio),
-                        TAG, "bind i2c");
+// Seed the incremental flush estimate (us per byte, Q8) from the bus cost.
+static void seed_step_cost(struct ssd1306_t *d) {
+    const uint64_t q8 = ((uint64_t)d->cost.byte_ns << 8) / 1000;
+    d->step_cost = (uint16_t)(q8 < 1 ? 1 : q8 > UINT16_MAX ? UINT16_MAX : q8);
+}
+
+// The panel has to show the store's fb: all of it is dirty, and with a valid
+// shadow the snapshot trims that down to what actually differs.
+static void rtc_resume(struct ssd1306_t *d) {
+    if (d->rtc)
+        mark_dirty(d, 0, 0, d->width - 1, d->height - 1);
+}
+
+// Warm attach: the panel kept its configuration and RAM, so only check that
+// it answers. The start line is part of the init sequence anyway. SPI has no
+// ACK and the check cannot fail there, so with an rtc_store that was not
+// resumed (nothing was saved before the reset) SPI initializes cold.
+static esp_err_t warm_attach(struct ssd1306_t *d) {
+    if (d->bus == SSD1306_SPI && d->rtc && !d->rtc_resumed)
+        return ESP_ERR_INVALID_STATE;
+    const uint8_t cmds[] = {0x40}; // STARTLINE(0)
+    return d->vt->send_cmd(d->bus_ctx, cmds, sizeof(cmds));
+}
+
+// Finish creating a bound panel: reset, init, bus costs. With lazy_init only
+// the reset happens here; link_check() does the rest before the first flush.
+// Strip mode sends without link_check(), so it always initializes now.
+static esp_err_t bring_up(struct ssd1306_t *d, const ssd1306_config_t *cfg) {
+    if (cfg->warm_attach) {
+        // No measurement either: it would rewrite page 0.
+        const esp_err_t err = warm_attach(d);
+        if (err == ESP_OK) {
+            seed_step_cost(d);
+            rtc_resume(d);
+            d->initialized = true;
+            return ESP_OK;
+        }
+        ESP_LOGW(TAG, "warm attach failed (%s), initializing",
+                 esp_err_to_name(err));
+    }
+    d->shadow_ok = false; // panel RAM is lost with the reset
     if (d->vt->reset)
         ESP_RETURN_ON_ERROR(d->vt->reset(d->bus_ctx), TAG, "reset");
-    ESP_RETURN_ON_ERROR(run_init_sequence(d), TAG, "init seq");
+    d->cost_pending = !cfg->bus_cost.byte_ns && d->stage;
+    if (cfg->lazy_init && !d->strip_bufs) {
+        d->init_pending = true;
+    } else {
+        ESP_RETURN_ON_ERROR(run_init_sequence(d), TAG, "init seq");
+        if (d->cost_pending) {
+            memcpy(d->stage, d->fb, d->width);
+            measure_cost(d, d->stage);
+            d->cost_pending = false;
+        }
+    }
+    seed_step_cost(d);
+    rtc_resume(d);
 
     d->initialized = true;
     return ESP_OK;
 }
 
+// ----- Public API -----
+static esp_err_t new_i2c(const ssd1306_config_t *cfg, ssd1306_static_t *mem,
+                         ssd1306_handle_t *out) {
+    struct ssd1306_t *d = NULL;
+    ESP_RETURN_ON_ERROR(new_common(cfg, mem, out, &d), TAG, "alloc");
+
+    ESP_RETURN_ON_ERROR(ssd1306_bind_i2c(d, &cfg->iface.i2c), TAG, "bind i2c");
+    return bring_up(d, cfg);
+}
+
+static esp_err_t new_spi(const ssd1306_config_t *cfg, ssd1306_static_t *mem,
+                         ssd1306_handle_t *out) {
+    struct ssd1306_t *d = NULL;
+    ESP_RETURN_ON_ERROR(new_common(cfg, mem, out, &d), TAG, "alloc");
+
+    ESP_RETURN_ON_ERROR(ssd1306_bind_spi(d, &cfg->iface.spi), TAG, "bind spi");
+    return bring_up(d, cfg);
+}
+
+esp_err_t ssd1306_new_i2c(const ssd1306_config_t *cfg, ssd1306_handle_t *out) {
+    return new_i2c(cfg, NULL, out);
+}
+
+esp_err_t ssd1306_new_i2c_static(const ssd1306_config_t *cfg,
+                                 ssd1306_static_t *mem, ssd1306_handle_t *out) {
+    ESP_RETURN_ON_FALSE(mem, ESP_ERR_INVALID_ARG, TAG, "mem=NULL");
+    return new_i2c(cfg, mem, out);
+}
+
 esp_err_t ssd1306_new_spi(const ssd1306_config_t *cfg, ssd1306_handle_t *out) {
+    return new_spi(cfg, NULL, out);
+}
+
+esp_err_t ssd1306_new_spi_static(const ssd1306_config_t *cfg,
+                                 ssd1306_static_t *mem, ssd1306_handle_t *out) {
+    ESP_RETURN_ON_FALSE(mem, ESP_ERR_INVALID_ARG, TAG, "mem=NULL");
+    return new_spi(cfg, mem, out);
+}
+
+esp_err_t ssd1306_new_canvas(const ssd1306_config_t *cfg,
+                             ssd1306_handle_t       *out) {
     struct ssd1306_t *d = NULL;
-    ESP_RETURN_ON_ERROR(new_common(cfg, out, &d), TAG, "alloc");
+    ESP_RETURN_ON_ERROR(new_common(cfg, NULL, out, &d), TAG, "alloc");
 
-    ESP_RETURN_ON_ERROR(
-        ssd1306_bind_spi(d, cfg->iface.spi.host, cfg->iface.spi.cs_gpio,
-                         cfg->iface.spi.dc_gpio, cfg->iface.spi.rst_gpio,
-                         cfg->iface.spi.clk_hz),
-        TAG, "bind spi");
-    if (d->vt->reset)
-        ESP_RETURN_ON_ERROR(d->vt->reset(d->bus_ctx), TAG, "reset");
-    ESP_RETURN_ON_ERROR(run_init_sequence(d), TAG, "init seq");
+    ESP_RETURN_ON_ERROR(ssd1306_bind_canvas(d, &cfg->iface.canvas), TAG,
+                        "bind canvas");
 
     d->initialized = true;
     return ESP_OK;
@@ -291,7 +1036,8 @@ esp_err_t ssd1306_set_font(ssd1306_handle_t h, const ssd1306_font_t *font) {
     if (!d)
         return ESP_ERR_INVALID_STATE;
 
-    LOCK(d);
+    if (LOCK(d) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
         UNLOCK(d);
         return ESP_ERR_INVALID_STATE;
@@ -306,7 +1052,15 @@ esp_err_t ssd1306_del(ssd1306_handle_t h) {
     if (!d)
         return ESP_ERR_INVALID_ARG;
 
-    LOCK(d);
+    // The render task draws through this handle and the flush task sends
+    // from it; stop them first.
+    (void)ssd1306_queue_stop(d);
+    (void)ssd1306_pipeline_stop(d);
+    strip_stop(d);
+
+    // Wait for any flush in progress before tearing down.
+    xSemaphoreTake(d->flush_lock, portMAX_DELAY);
+    lock_bands(d, LOCK_ALL, portMAX_DELAY);
     d->initialized = false;
 
     // Stop talking to the device first.
@@ -314,16 +1068,26 @@ esp_err_t ssd1306_del(ssd1306_handle_t h) {
         (void)ssd1306_unbind_i2c(d);
     } else if (d->bus == SSD1306_SPI) {
         (void)ssd1306_unbind_spi(d);
+    } else if (d->bus == SSD1306_CANVAS) {
+        (void)ssd1306_unbind_canvas(d);
     } else {
         ESP_LOGE(TAG, "Invalid bus: %d", d->bus);
     }
 
-    if (d->driver_owns_fb && d->fb)
-        free(d->fb);
+    if (d->driver_owns_fb && d->fb && !d->rtc)
+        ssd1306_buf_free(d, SSD1306_BUF_FB, d->fb);
+    if (!d->static_mem) {
+        ssd1306_buf_free(d, SSD1306_BUF_STAGE, d->stage);
+        ssd1306_buf_free(d, SSD1306_BUF_GATHER, d->gather);
+    }
 
     UNLOCK(d);
-    vSemaphoreDelete(d->lock);
-    free(d);
+    xSemaphoreGive(d->flush_lock);
+    for (int b = 0; b < d->n_bands; ++b)
+        vSemaphoreDelete(d->band_lock[b]);
+    vSemaphoreDelete(d->flush_lock);
+    if (!d->static_mem)
+        free(d);
 
     return ESP_OK;
 }
@@ -337,14 +1101,17 @@ esp_err_t ssd1306_draw_pixel(ssd1306_handle_t h, int x, int y, bool on) {
     if ((unsigned)x >= d->width || (unsigned)y >= d->height)
         return ESP_ERR_INVALID_ARG;
 
-    LOCK(d);
+    const uint8_t held = band_mask(d, y, y);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
-    draw_pixel_fast(d, x, y, on);
+    if (y >= d->clip_y0 && y <= d->clip_y1)
+        draw_pixel_fast(d, x, y, on);
     mark_dirty(d, x, y, x, y);
-    UNLOCK(d);
+    unlock_bands(d, held);
 
     return ESP_OK;
 }
@@ -370,29 +1137,40 @@ esp_err_t ssd1306_draw_rect(ssd1306_handle_t h, int x, int y, int w, int hgt,
     if (y1 >= (int)d->height)
         y1 = (int)d->height - 1;
 
-    LOCK(d);
+    const uint8_t held = band_mask(d, y0, y1);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
 
     if (!fill) {
         // top/bottom horizontal edges
         for (int xx = x0; xx <= x1; ++xx) {
-            draw_pixel_fast(d, xx, y0, true);
-            draw_pixel_fast(d, xx, y1, true);
+            plot_if_visible(d, xx, y0);
+            plot_if_visible(d, xx, y1);
         }
         // left/right vertical edges
         for (int yy = y0; yy <= y1; ++yy) {
-            draw_pixel_fast(d, x0, yy, true);
-            draw_pixel_fast(d, x1, yy, true);
+            plot_if_visible(d, x0, yy);
+            plot_if_visible(d, x1, yy);
         }
         mark_dirty(d, x0, y0, x1, y1);
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_OK;
     }
 
-    // --- filled: page-aware fill ---
+    // --- filled: page-aware fill, limited to the rows backed by fb ---
+    mark_dirty(d, x0, y0, x1, y1);
+    if (y0 < d->clip_y0)
+        y0 = d->clip_y0;
+    if (y1 > d->clip_y1)
+        y1 = d->clip_y1;
+    if (y0 > y1) {
+        unlock_bands(d, held);
+        return ESP_OK;
+    }
     const int     first_page = y0 >> 3;
     const int     last_page  = y1 >> 3;
 
@@ -402,7 +1180,7 @@ esp_err_t ssd1306_draw_rect(ssd1306_handle_t h, int x, int y, int w, int hgt,
         (uint8_t)(0xFFu >> (7 - (y1 & 7))); // bits from 0 to y1%8
 
     for (int page = first_page; page <= last_page; ++page) {
-        const size_t row_base   = fb_index(d, x0, page);
+        const size_t row_base   = fb_index(d, x0, page - d->fb_page0);
         const int    bytes_wide = (x1 - x0 + 1);
 
         if (first_page == last_page) {
@@ -422,8 +1200,7 @@ esp_err_t ssd1306_draw_rect(ssd1306_handle_t h, int x, int y, int w, int hgt,
         }
     }
 
-    mark_dirty(d, x0, y0, x1, y1);
-    UNLOCK(d);
+    unlock_bands(d, held);
     return ESP_OK;
 }
 
@@ -452,14 +1229,17 @@ esp_err_t ssd1306_draw_line(ssd1306_handle_t h, int x0, int y0, int x1, int y1,
     int sy  = (y0 < y1) ? 1 : -1;
     int err = dx - dy;
 
-    LOCK(d);
+    const uint8_t held = band_mask(d, by0, by1);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
 
     while (1) {
-        draw_pixel_fast(d, x0, y0, on);
+        if ((unsigned)x0 < d->width && y0 >= d->clip_y0 && y0 <= d->clip_y1)
+            draw_pixel_fast(d, x0, y0, on);
 
         if (x0 == x1 && y0 == y1)
             break;
@@ -476,7 +1256,7 @@ esp_err_t ssd1306_draw_line(ssd1306_handle_t h, int x0, int y0, int x1, int y1,
     }
 
     mark_dirty(d, bx0, by0, bx1, by1);
-    UNLOCK(d);
+    unlock_bands(d, held);
     return ESP_OK;
 }
 
@@ -499,9 +1279,11 @@ esp_err_t ssd1306_draw_circle(ssd1306_handle_t h, int xc, int yc, int r,
     int bx1 = xc + r;
     int by1 = yc + r;
 
-    LOCK(d);
+    const uint8_t held = band_mask(d, by0, by1);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized) {
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -552,7 +1334,7 @@ esp_err_t ssd1306_draw_circle(ssd1306_handle_t h, int xc, int yc, int r,
     // One bbox mark is sufficient
     mark_dirty(d, bx0, by0, bx1, by1);
 
-    UNLOCK(d);
+    unlock_bands(d, held);
     return ESP_OK;
 }
 
@@ -569,20 +1351,28 @@ esp_err_t ssd1306_draw_text_scaled(ssd1306_handle_t h, int x, int y,
     if (scale < 1)
         scale = 1;
 
-    LOCK(d);
-    if (!d->initialized) {
-        UNLOCK(d);
+    // The font decides which rows the text covers, and so which bands to
+    // lock; use the same font snapshot for both.
+    const ssd1306_font_t *f = d->font;
+    if (!f)
         return ESP_ERR_INVALID_STATE;
-    }
-    if (!d->font) {
-        UNLOCK(d);
+
+    const int gw    = (int)f->width;
+    const int gh    = (int)f->height;
+
+    int       lines = 1;
+    for (const char *p = text; *p; ++p)
+        lines += (*p == '\n');
+    const int     text_y1 = y + lines * (gh * scale + SSD1306_TEXT_VSPC) - 1;
+
+    const uint8_t held    = band_mask(d, y, text_y1);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
+    if (!d->initialized) {
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
 
-    const ssd1306_font_t *f     = d->font;
-    const int             gw    = (int)f->width;
-    const int             gh    = (int)f->height;
-
     int                   cur_x = x;
     int                   cur_y = y;
 
@@ -619,7 +1409,7 @@ esp_err_t ssd1306_draw_text_scaled(ssd1306_handle_t h, int x, int y,
                             int px = base_x + sx;
                             int py = base_y + sy;
                             if ((unsigned)px < d->width &&
-                                (unsigned)py < d->height)
+                                py >= d->clip_y0 && py <= d->clip_y1)
                                 draw_pixel_fast(d, px, py, on);
                         }
                     }
@@ -640,7 +1430,7 @@ esp_err_t ssd1306_draw_text_scaled(ssd1306_handle_t h, int x, int y,
     if (bx1 >= bx0 && by1 >= by0)
         mark_dirty(d, bx0, by0, bx1, by1);
 
-    UNLOCK(d);
+    unlock_bands(d, held);
     return ESP_OK;
 }
 
@@ -658,9 +1448,11 @@ esp_err_t ssd1306_draw_text_wrapped_scaled(ssd1306_handle_t h, int x, int y,
     if (w <= 0 || hgt <= 0 || scale < 1)
         return ESP_ERR_INVALID_ARG;
 
-    LOCK(d);
+    const uint8_t held = band_mask(d, y, y + hgt - 1);
+    if (lock_bands(d, held, d->lock_timeout) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
     if (!d->initialized || !d->font) {
-        UNLOCK(d);
+        unlock_bands(d, held);
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -853,60 +1645,616 @@ esp_err_t ssd1306_draw_text_wrapped_scaled(ssd1306_handle_t h, int x, int y,
 
     if (touched)
         mark_dirty(d, bx0, by0, bx1, by1);
-    UNLOCK(d);
+    unlock_bands(d, held);
     return ESP_OK;
 }
 
-esp_err_t ssd1306_display(ssd1306_handle_t h) {
-    struct ssd1306_t *d = h;
-    if (!d)
-        return ESP_ERR_INVALID_STATE;
+// ----- Flush path -----
+
+// How a partial window goes out. Its page rows are not contiguous in the
+// buffer unless it spans the full width.
+typedef enum {
+    PLAN_PAGES,  // one transaction per page row, straight from the buffer
+    PLAN_GATHER, // pack the rows into d->gather, one transaction
+    PLAN_WIDEN,  // snapshot and send full-width rows, one transaction
+} flush_plan_t;
+
+// Estimated cost of n data bytes in the transactions bus_send would use
+static uint64_t send_cost_ns(const struct ssd1306_t *d, size_t n) {
+    const size_t max   = d->fair.max_xfer_bytes;
+    const size_t xfers = max ? (n + max - 1) / max : 1;
+    return (uint64_t)xfers * d->cost.setup_ns +
+           (uint64_t)(xfers - 1) * d->fair.gap_us * 1000 +
+           (uint64_t)n * d->cost.byte_ns;
+}
+
+// Pick the cheapest plan for b on this bus and optionally return its
+// predicted time including addressing. Widening must be decided before the
+// snapshot (widen), since only then are the extra columns current.
+static flush_plan_t plan_flush(const struct ssd1306_t *d,
+                               const ssd1306_box_t *b, bool widen,
+                               uint64_t *cost_ns) {
+    const size_t wide  = (size_t)(b->x1 - b->x0 + 1);
+    const size_t pages = (size_t)((b->y1 >> 3) - (b->y0 >> 3) + 1);
+    if (!d->ctrl->windowed) {
+        // Page addressing: every page row is addressed and sent on its own,
+        // and wider rows would only add bytes.
+        if (cost_ns)
+            *cost_ns = pages * (d->cost.cmd_ns + send_cost_ns(d, wide));
+        return PLAN_PAGES;
+    }
+    flush_plan_t plan = PLAN_PAGES;
+    uint64_t     best  = pages * send_cost_ns(d, wide);
+    if (wide == d->width || pages == 1) {
+        // Already a single run
+        if (cost_ns)
+            *cost_ns = d->cost.cmd_ns + send_cost_ns(d, wide * pages);
+        return plan;
+    }
+
+    if (d->gather) {
+        const uint64_t c =
+            send_cost_ns(d, wide * pages) + wide * pages * COPY_NS;
+        if (c < best) {
+            best = c;
+            plan = PLAN_GATHER;
+        }
+    }
+    if (widen) {
+        // The extra columns are also copied under the drawing lock.
+        const uint64_t c = send_cost_ns(d, d->width * pages) +
+                           (d->width - wide) * pages * COPY_NS;
+        if (c < best) {
+            best = c;
+            plan = PLAN_WIDEN;
+        }
+    }
+    if (cost_ns)
+        *cost_ns = d->cost.cmd_ns + best;
+    return plan;
+}
 
-    LOCK(d);
+// Copy the rows of box from fb into dst. Rows keep their framebuffer offsets.
+// Requires: lock is held.
+static void copy_rows(const struct ssd1306_t *d, uint8_t *dst,
+                      const ssd1306_box_t *b) {
+    const int    p0 = b->y0 >> 3, p1 = b->y1 >> 3;
+    const size_t bytes_wide = (size_t)(b->x1 - b->x0 + 1);
+    if (bytes_wide == d->width) {
+        const size_t off = fb_index(d, 0, p0);
+        memcpy(&dst[off], &d->fb[off], bytes_wide * (size_t)(p1 - p0 + 1));
+        return;
+    }
+    for (int p = p0; p <= p1; ++p) {
+        const size_t off = fb_index(d, b->x0, p);
+        memcpy(&dst[off], &d->fb[off], bytes_wide);
+    }
+}
+
+// Shrink box to the columns per page where fb differs from the shadow.
+// Requires: lock is held.
+static void shadow_diff(const struct ssd1306_t *d, ssd1306_box_t *box) {
+    const int     p0  = box->y0 >> 3, p1 = box->y1 >> 3;
+    ssd1306_box_t out = SSD1306_BOX_EMPTY;
+    for (int p = p0; p <= p1; ++p) {
+        const uint8_t *f = &d->fb[fb_index(d, 0, p)];
+        const uint8_t *s = &d->shadow[fb_index(d, 0, p)];
+        int            l = box->x0, r = box->x1;
+        while (l <= r && f[l] == s[l])
+            ++l;
+        if (l > r)
+            continue;
+        while (f[r] == s[r])
+            --r;
+        const ssd1306_box_t row = {(int16_t)l, (int16_t)(p << 3), (int16_t)r,
+                                   (int16_t)((p << 3) + 7)};
+        ssd1306_box_union(&out, &row);
+    }
+    if (out.y1 >= d->height)
+        out.y1 = (int16_t)(d->height - 1);
+    *box = out;
+}
+
+// Record box from src as sent to the panel. Requires: flush_lock.
+static void shadow_note(struct ssd1306_t *d, const uint8_t *src,
+                        const ssd1306_box_t *b) {
+    const int    p0 = b->y0 >> 3, p1 = b->y1 >> 3;
+    const size_t bytes_wide = (size_t)(b->x1 - b->x0 + 1);
+    for (int p = p0; p <= p1; ++p) {
+        const size_t off = fb_index(d, b->x0, p);
+        memcpy(&d->shadow[off], &src[off], bytes_wide);
+    }
+    // A whole screen makes it valid again after a reset.
+    if (bytes_wide == d->width && p0 == 0 && p1 == ((d->height - 1) >> 3))
+        d->shadow_ok = true;
+}
+
+esp_err_t ssd1306_snapshot(struct ssd1306_t *d, uint8_t *dst,
+                           ssd1306_box_t *box) {
+    if (LOCK(d) != ESP_OK)
+        return ESP_ERR_TIMEOUT;
+    const int64_t t_lock = esp_timer_get_time();
     if (!d->initialized) {
         UNLOCK(d);
         return ESP_ERR_INVALID_STATE;
     }
 
+    // partial flush using bbox (already clipped by mark_dirty)
+    dirty_take(d, box);
+
     if (!d->driver_owns_fb) {
-        // full flush
-        const uint8_t p0 = 0, p1 = (uint8_t)((d->height >> 3) - 1);
-        esp_err_t     err = set_window(d, 0, (uint8_t)(d->width - 1), p0, p1);
+        // User-managed framebuffer may change behind our back: full flush.
+        *box = (ssd1306_box_t){0, 0, d->width - 1, d->height - 1};
+    }
+    // With the pipeline a frame may still be waiting to be sent, so the
+    // shadow can be behind the panel.
+    if (d->shadow_ok && !d->pipe && !ssd1306_box_empty(box))
+        shadow_diff(d, box);
+    if (!ssd1306_box_empty(box) && !d->canvas &&
+        plan_flush(d, box, true, NULL) == PLAN_WIDEN) {
+        box->x0 = 0;
+        box->x1 = (int16_t)(d->width - 1);
+    }
+    if (!ssd1306_box_empty(box))
+        copy_rows(d, dst, box);
+
+    const uint32_t hold_us = (uint32_t)(esp_timer_get_time() - t_lock);
+    UNLOCK(d);
+
+    portENTER_CRITICAL(&d->spin);
+    d->stats.lock_hold_us_last = hold_us;
+    if (hold_us > d->stats.lock_hold_us_max)
+        d->stats.lock_hold_us_max = hold_us;
+    portEXIT_CRITICAL(&d->spin);
+    return ESP_OK;
+}
+
+// Address box on the panel and send its rows from src.
+static esp_err_t send_window(struct ssd1306_t *d, uint8_t *src,
+                             const ssd1306_box_t *b) {
+    uint64_t           predict_ns;
+    const flush_plan_t plan    = plan_flush(d, b, false, &predict_ns);
+    const int64_t      t_start = esp_timer_get_time();
+
+    const int    p0   = b->y0 >> 3, p1 = b->y1 >> 3;
+    const size_t wide = (size_t)(b->x1 - b->x0 + 1);
+    bool         gap  = false;
+    esp_err_t    err  = d->vt->begin ? d->vt->begin(d->bus_ctx) : ESP_OK;
+    const bool   held = err == ESP_OK;
+    if (err == ESP_OK && !d->ctrl->windowed) {
+        // Page addressing: each page row gets its own start address.
+        for (int p = p0; p <= p1 && err == ESP_OK; ++p) {
+            err = set_window(d, (uint8_t)b->x0, (uint8_t)b->x1, (uint8_t)p,
+                             (uint8_t)p, &gap);
+            if (err == ESP_OK)
+                err = bus_send(d, true, &src[fb_index(d, b->x0, p)], wide,
+                               true, &gap);
+        }
+    } else if (err == ESP_OK) {
+        err = set_window(d, (uint8_t)b->x0, (uint8_t)b->x1, (uint8_t)p0,
+                         (uint8_t)p1, &gap);
+    }
+    if (err == ESP_OK && d->ctrl->windowed) {
+        if (wide == d->width) {
+            // Full-width rows are contiguous: one burst.
+            err = bus_send(d, true, &src[fb_index(d, 0, p0)],
+                           wide * (size_t)(p1 - p0 + 1), true, &gap);
+        } else if (plan == PLAN_GATHER) {
+            // The column window wraps to the next page, so packed rows
+            // follow on seamlessly.
+            for (int p = p0; p <= p1; ++p) {
+                memcpy(&d->gather[(size_t)(p - p0) * wide],
+                       &src[fb_index(d, b->x0, p)], wide);
+            }
+            err = bus_send(d, true, d->gather, wide * (size_t)(p1 - p0 + 1),
+                           true, &gap);
+        } else {
+            for (int p = p0; p <= p1 && err == ESP_OK; ++p) {
+                err = bus_send(d, true, &src[fb_index(d, b->x0, p)], wide,
+                               true, &gap);
+            }
+        }
+    }
+    if (held && d->vt->end) {
+        const esp_err_t e = d->vt->end(d->bus_ctx);
         if (err == ESP_OK)
-            err = d->vt->send_data(d->bus_ctx, d->fb, d->fb_len);
-        dirty_reset(d);
-        UNLOCK(d);
-        return err;
+            err = e;
     }
 
-    // partial flush using bbox; no-op if nothing dirty
-    if (!d->dirty) {
-        UNLOCK(d);
+    ESP_LOGD(TAG, "flush %dx%d plan %d: predicted %lu us, took %lu us",
+             b->x1 - b->x0 + 1, b->y1 - b->y0 + 1, plan,
+             (unsigned long)(predict_ns / 1000),
+             (unsigned long)(esp_timer_get_time() - t_start));
+    return err;
+}
+
+static inline esp_err_t transmit(struct ssd1306_t *d, uint8_t *src,
+                                 const ssd1306_box_t *b) {
+    if (d->canvas)
+        return ssd1306_canvas_send_rows(d, src, b);
+    const esp_err_t err = send_window(d, src, b);
+    if (err == ESP_OK && d->shadow)
+        shadow_note(d, src, b);
+    return err;
+}
+
+static void record_flush(struct ssd1306_t *d, uint32_t flush_us) {
+    portENTER_CRITICAL(&d->spin);
+    d->stats.flushes++;
+    d->stats.flush_us_last = flush_us;
+    if (flush_us > d->stats.flush_us_max)
+        d->stats.flush_us_max = flush_us;
+    portEXIT_CRITICAL(&d->spin);
+}
+
+// ----- Bus recovery -----
+// A failed transfer takes the panel offline. Flushes then skip the bus until
+// the backoff expires; the next one resets and re-initializes the panel and
+// queues a full resend. A canvas has no link of its own; its tiles do.
+
+static void link_down(struct ssd1306_t *d, esp_err_t err) {
+    const uint32_t next = d->backoff_ms * 2;
+    d->backoff_ms       = !d->backoff_ms ? RECOVER_MIN_MS
+                          : next < d->recover_max_ms ? next
+                                                     : d->recover_max_ms;
+    d->recover_at_us = esp_timer_get_time() + (int64_t)d->backoff_ms * 1000;
+    if (!d->offline)
+        ESP_LOGW(TAG, "panel unreachable (%s), drawing continues in RAM",
+                 esp_err_to_name(err));
+    d->offline   = true;
+    d->shadow_ok = false; // queued sends may not have arrived
+
+    portENTER_CRITICAL(&d->spin);
+    d->stats.bus_errors++;
+    portEXIT_CRITICAL(&d->spin);
+}
+
+// ESP_OK if the panel can be sent to, recovering it first when a retry is
+// due or sending the deferred init sequence of a lazy_init panel (a pending
+// cost measurement rewrites page 0 from src, the buffer about to be sent).
+// Requires: flush_lock.
+static esp_err_t link_check(struct ssd1306_t *d, uint8_t *src) {
+    if ((!d->offline && !d->init_pending) || d->canvas)
         return ESP_OK;
+    if (d->offline && esp_timer_get_time() < d->recover_at_us)
+        return ESP_ERR_TIMEOUT;
+
+    esp_err_t err = ESP_OK;
+    if (d->offline) {
+        err = d->vt->recover ? d->vt->recover(d->bus_ctx) : ESP_OK;
+        if (err == ESP_OK && d->vt->reset)
+            err = d->vt->reset(d->bus_ctx);
     }
-    int x0 = d->dx0, y0 = d->dy0, x1 = d->dx1, y1 = d->dy1;
-    if (x0 < 0)
-        x0 = 0;
-    if (y0 < 0)
-        y0 = 0;
-    if (x1 >= (int)d->width)
-        x1 = d->width - 1;
-    if (y1 >= (int)d->height)
-        y1 = d->height - 1;
+    if (err == ESP_OK)
+        err = run_init_sequence(d);
+    if (err != ESP_OK) {
+        link_down(d, err);
+        return err;
+    }
+
+    if (d->init_pending) {
+        d->init_pending = false;
+        if (d->cost_pending) {
+            // Only this flush's region of src is valid; page 0 now shows
+            // whatever else was staged there, so send it again next time.
+            measure_cost(d, src);
+            seed_step_cost(d);
+            d->cost_pending = false;
+            mark_dirty(d, 0, 0, d->width - 1, 7);
+        }
+    }
+    if (!d->offline)
+        return ESP_OK;
+
+    d->offline    = false;
+    d->backoff_ms = 0;
+    // Display RAM is unknown after the reset.
+    mark_dirty(d, 0, 0, d->width - 1, d->height - 1);
+    portENTER_CRITICAL(&d->spin);
+    d->stats.recoveries++;
+    portEXIT_CRITICAL(&d->spin);
+    ESP_LOGI(TAG, "panel recovered");
+    return ESP_OK;
+}
 
-    uint8_t   p0 = (uint8_t)(y0 >> 3), p1 = (uint8_t)(y1 >> 3);
-    esp_err_t err = set_window(d, (uint8_t)x0, (uint8_t)x1, p0, p1);
+esp_err_t ssd1306_send_rows(struct ssd1306_t *d, uint8_t *src,
+                            const ssd1306_box_t *b) {
+    const int64_t t_start = esp_timer_get_time();
+    esp_err_t     err     = link_check(d, src);
     if (err == ESP_OK) {
-        const int bytes_wide = (x1 - x0 + 1);
-        for (uint8_t p = p0; p <= p1; ++p) {
-            const uint8_t *row = &d->fb[(size_t)p * d->width + (size_t)x0];
-            err = d->vt->send_data(d->bus_ctx, row, (size_t)bytes_wide);
-            if (err != ESP_OK)
+        err = transmit(d, src, b);
+        if (err != ESP_OK && !d->canvas)
+            link_down(d, err);
+    }
+
+    if (err != ESP_OK && d->driver_owns_fb) {
+        // Keep the region pending so the next flush retries it.
+        mark_dirty(d, b->x0, b->y0, b->x1, b->y1);
+    }
+    record_flush(d, (uint32_t)(esp_timer_get_time() - t_start));
+    return err;
+}
+
+esp_err_t ssd1306_display(ssd1306_handle_t h) {
+    struct ssd1306_t *d = h;
+    if (!d)
+        return ESP_ERR_INVALID_STATE;
+    if (d->pipe)
+        return ssd1306_pipeline_submit(d);
+    if (d->strip_bufs)
+        return ESP_ERR_INVALID_STATE;
+
+    // Only one flush may use the staging buffer and the bus at a time.
+    if (!ssd1306_take(d, d->flush_lock, d->lock_timeout, xTaskGetTickCount()))
+        return ESP_ERR_TIMEOUT;
+
+    // Snapshot what needs sending, then let drawing continue. An unfinished
+    // incremental frame is folded in and abandoned.
+    ssd1306_box_t box = d->step_box;
+    d->step_box       = SSD1306_BOX_EMPTY;
+    esp_err_t err     = ssd1306_snapshot(d, d->stage, &box);
+    if (err == ESP_OK && !ssd1306_box_empty(&box))
+        err = ssd1306_send_rows(d, d->stage, &box);
+
+    xSemaphoreGive(d->flush_lock);
+    return err;
+}
+
+esp_err_t ssd1306_display_step(ssd1306_handle_t h, uint32_t budget_us,
+                               bool *more) {
+    struct ssd1306_t *d = h;
+    if (more)
+        *more = false;
+    if (!d)
+        return ESP_ERR_INVALID_STATE;
+    if (d->pipe || d->strip_bufs)
+        return ESP_ERR_INVALID_STATE;
+
+    const int64_t t_start = esp_timer_get_time();
+    if (!ssd1306_take(d, d->flush_lock, d->lock_timeout, xTaskGetTickCount()))
+        return ESP_ERR_TIMEOUT;
+
+    ssd1306_box_t *b   = &d->step_box;
+    esp_err_t      err = link_check(d, d->stage);
+    if (err == ESP_OK && ssd1306_box_empty(b)) {
+        err        = ssd1306_snapshot(d, d->stage, b);
+        d->step_x  = b->x0;
+        d->step_us = 0;
+    }
+
+    // One chunk = a run of columns in the top page row of the box.
+    bool first = true;
+    while (err == ESP_OK && !ssd1306_box_empty(b)) {
+        const int64_t now  = esp_timer_get_time();
+        const int64_t left = (int64_t)budget_us - (now - t_start);
+        int64_t       n    = left > 0 ? (left << 8) / d->step_cost : 0;
+        n -= STEP_OVERHEAD;
+        if (n < STEP_MIN_CHUNK) {
+            if (!first)
                 break;
+            n = STEP_MIN_CHUNK; // always make progress
+        }
+
+        const int     page  = b->y0 >> 3;
+        const int     x1    = (d->step_x + n - 1 < b->x1) ? d->step_x + n - 1
+                                                          : b->x1;
+        ssd1306_box_t chunk = {d->step_x, (int16_t)(page << 3), (int16_t)x1,
+                               (int16_t)((page << 3) + 7)};
+        err                 = transmit(d, d->stage, &chunk);
+
+        // Track the per-byte cost of chunks (EWMA, 1/4 weight).
+        const uint32_t dt     = (uint32_t)(esp_timer_get_time() - now);
+        const int64_t  sample = ((int64_t)dt << 8) /
+                               (x1 - d->step_x + 1 + STEP_OVERHEAD);
+        int64_t        cost   = d->step_cost + (sample - d->step_cost) / 4;
+        d->step_cost = (uint16_t)(cost < 1 ? 1 : cost > UINT16_MAX ? UINT16_MAX
+                                                                   : cost);
+        d->step_us += dt;
+        first = false;
+        if (err != ESP_OK) {
+            if (!d->canvas)
+                link_down(d, err);
+            break;
+        }
+
+        if (x1 < b->x1) {
+            d->step_x = (int16_t)(x1 + 1);
+        } else {
+            d->step_x = b->x0;
+            b->y0     = (int16_t)((page + 1) << 3);
         }
     }
+
+    if (err != ESP_OK) {
+        // Keep what was not sent pending for the next flush.
+        if (!ssd1306_box_empty(b) && d->driver_owns_fb)
+            mark_dirty(d, b->x0, b->y0, b->x1, b->y1);
+        *b = SSD1306_BOX_EMPTY;
+    } else if (ssd1306_box_empty(b) && d->step_us) {
+        record_flush(d, d->step_us);
+        d->step_us = 0;
+    }
+    const bool pending = !ssd1306_box_empty(b);
+    xSemaphoreGive(d->flush_lock);
+
+    if (more)
+        *more = pending || ssd1306_dirty_bytes(d);
+    return err;
+}
+
+esp_err_t ssd1306_draw_strips(ssd1306_handle_t h, ssd1306_strip_cb_t cb,
+                              void *arg) {
+    struct ssd1306_t *d = h;
+    if (!d || !cb)
+        return ESP_ERR_INVALID_ARG;
+    if (!d->strip_bufs || !d->initialized)
+        return ESP_ERR_INVALID_STATE;
+    if (!ssd1306_take(d, d->flush_lock, d->lock_timeout, xTaskGetTickCount()))
+        return ESP_ERR_TIMEOUT;
+
+    struct ssd1306_strip_t *s       = d->strip;
+    const int64_t           t_start = esp_timer_get_time();
+    esp_err_t               err     = ESP_OK;
+    if (s)
+        s->err = ESP_OK;
+
+    for (int page = 0; page < (d->height >> 3) && err == ESP_OK; ++page) {
+        const int i = page % d->strip_bufs;
+        if (s)
+            xSemaphoreTake(s->idle, portMAX_DELAY); // strip i has been sent
+
+        // Point drawing at strip i, clipped to this page.
+        if (LOCK(d) != ESP_OK) {
+            if (s)
+                xSemaphoreGive(s->idle);
+            err = ESP_ERR_TIMEOUT;
+            break;
+        }
+        d->fb_page0 = (int16_t)(page - i);
+        d->clip_y0  = (int16_t)(page << 3);
+        d->clip_y1  = (int16_t)((page << 3) + 7);
+        memset(&d->fb[i * d->width], 0, d->width);
+        UNLOCK(d);
+
+        cb(d, page, arg);
+
+        if (s) {
+            const int item = (page << 1) | i;
+            xQueueSend(s->todo, &item, portMAX_DELAY);
+        } else {
+            err = send_strip(d, d->fb, page);
+        }
+    }
+
+    if (s) {
+        // Wait for the last strips to go out.
+        xSemaphoreTake(s->idle, portMAX_DELAY);
+        xSemaphoreTake(s->idle, portMAX_DELAY);
+        xSemaphoreGive(s->idle);
+        xSemaphoreGive(s->idle);
+        if (err == ESP_OK)
+            err = s->err;
+    }
+
+    if (LOCK(d) == ESP_OK) {
+        d->clip_y0 = 1; // no strip: drawing has no effect
+        d->clip_y1 = 0;
+        UNLOCK(d);
+    }
     if (err == ESP_OK)
-        dirty_reset(d);
+        record_flush(d, (uint32_t)(esp_timer_get_time() - t_start));
+    xSemaphoreGive(d->flush_lock);
+    return err;
+}
+
+esp_err_t ssd1306_set_lock_timeout(ssd1306_handle_t h, TickType_t ticks) {
+    struct ssd1306_t *d = h;
+    if (!d)
+        return ESP_ERR_INVALID_ARG;
+    d->lock_timeout = ticks;
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_get_buf_info(ssd1306_handle_t h, ssd1306_buf_kind_t kind,
+                               ssd1306_buf_info_t *out) {
+    struct ssd1306_t *d = h;
+    if (!d || !out || (unsigned)kind >= SSD1306_BUF_COUNT)
+        return ESP_ERR_INVALID_ARG;
+
+    // Buffers change only with flush_lock held (pipeline start/stop) or
+    // from the queue owner; a torn read is harmless for a report.
+    *out = d->buf_info[kind];
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_wait_idle(ssd1306_handle_t h, uint32_t timeout_ms) {
+    struct ssd1306_t *d = h;
+    if (!d)
+        return ESP_ERR_INVALID_ARG;
+    if (!d->vt || !d->vt->wait_idle)
+        return ESP_OK;
+
+    // Nothing new gets queued meanwhile
+    const TickType_t start   = xTaskGetTickCount();
+    const TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    if (!ssd1306_take(d, d->flush_lock, timeout, start))
+        return ESP_ERR_TIMEOUT;
+    const TickType_t waited = xTaskGetTickCount() - start;
+    esp_err_t        err    = d->vt->wait_idle(
+        d->bus_ctx, waited >= timeout ? 0 : timeout - waited);
+    xSemaphoreGive(d->flush_lock);
+    return err;
+}
+
+esp_err_t ssd1306_get_bus_cost(ssd1306_handle_t h, ssd1306_bus_cost_t *out) {
+    struct ssd1306_t *d = h;
+    if (!d || !out)
+        return ESP_ERR_INVALID_ARG;
+
+    *out = d->cost; // set at creation only
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_set_bus_fairness(ssd1306_handle_t          h,
+                                   const ssd1306_fairness_t *fair) {
+    struct ssd1306_t *d = h;
+    if (!d || !fair)
+        return ESP_ERR_INVALID_ARG;
+
+    // Not in the middle of a flush
+    xSemaphoreTake(d->flush_lock, portMAX_DELAY);
+    d->fair = *fair;
+    xSemaphoreGive(d->flush_lock);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_rtc_save(ssd1306_handle_t h) {
+    struct ssd1306_t *d = h;
+    if (!d)
+        return ESP_ERR_INVALID_ARG;
+    if (!d->rtc)
+        return ESP_ERR_INVALID_STATE;
+
+    const TickType_t start = xTaskGetTickCount();
+    if (!ssd1306_take(d, d->flush_lock, d->lock_timeout, start))
+        return ESP_ERR_TIMEOUT;
+    // The shadow counts only once everything queued has arrived.
+    esp_err_t err = d->vt->wait_idle
+                        ? d->vt->wait_idle(d->bus_ctx, d->lock_timeout)
+                        : ESP_OK;
+    if (err != ESP_OK)
+        link_down(d, err);
+    if (LOCK(d) != ESP_OK) {
+        xSemaphoreGive(d->flush_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    struct ssd1306_rtc_t *r = d->rtc;
+    r->shadow_ok            = d->shadow_ok;
+    r->crc                  = rtc_crc(r, d->fb_len);
     UNLOCK(d);
+    xSemaphoreGive(d->flush_lock);
     return err;
 }
+
+esp_err_t ssd1306_get_stats(ssd1306_handle_t h, ssd1306_stats_t *out) {
+    struct ssd1306_t *d = h;
+    if (!d || !out)
+        return ESP_ERR_INVALID_ARG;
+
+    portENTER_CRITICAL(&d->spin);
+    *out = d->stats;
+    portEXIT_CRITICAL(&d->spin);
+    out->offline = d->offline;
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_reset_stats(ssd1306_handle_t h) {
+    struct ssd1306_t *d = h;
+    if (!d)
+        return ESP_ERR_INVALID_ARG;
+
+    portENTER_CRITICAL(&d->spin);
+    memset(&d->stats, 0, sizeof(d->stats));
+    portEXIT_CRITICAL(&d->spin);
+    return ESP_OK;
+}
@@ -0,0 +1,265 @@
+// SPDX-License-Identifier: MIT
+/*
+ * ssd1306_group.c - Flush scheduler for several displays on shared buses
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ */
+
+#include "ssd1306_private.h"
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+#include <string.h>
+
+#define GROUP_DEFAULT_STACK    3072
+#define GROUP_DEFAULT_PRIO     5
+#define GROUP_DEFAULT_DEADLINE 100     // ms, for requests without one
+#define GROUP_SLACK_US         2000    // deadlines this close count as equal
+#define GROUP_FPS_WINDOW_US    1000000 // FPS averaging window
+
+static const char *TAG = "SSD1306_GROUP";
+
+struct ssd1306_group_t;
+
+// One scheduler task per physical bus
+typedef struct {
+    struct ssd1306_group_t *g;
+    uint32_t                key;
+    TaskHandle_t            task;
+} group_bus_t;
+
+typedef struct {
+    struct ssd1306_t     *d;
+    group_bus_t          *bus;
+    bool                  pending;
+    int64_t               req_us;      // first request since last flush
+    int64_t               deadline_us; // earliest requested deadline
+
+    ssd1306_group_stats_t st;
+    int64_t               win_start_us;
+    uint32_t              win_flushes;
+} group_panel_t;
+
+struct ssd1306_group_t {
+    group_panel_t     panel[SSD1306_GROUP_MAX_PANELS];
+    group_bus_t       bus[SSD1306_GROUP_MAX_PANELS];
+    uint8_t           n_panels;
+    uint8_t           n_buses;
+
+    portMUX_TYPE      spin; // pending state and stats
+    volatile bool     stop;
+    SemaphoreHandle_t done; // counted up by exiting bus tasks
+    uint32_t          default_deadline_us;
+    uint32_t          stack_size;
+    UBaseType_t       priority;
+};
+
+// Pick the next panel to flush on bus and clear its pending flag, returning
+// the request time and deadline: earliest deadline first; among deadlines
+// within GROUP_SLACK_US of the earliest, panels reachable without a bus switch
+// (same mux channel) go first, then the smallest dirty area (the quickest
+// flush).
+static group_panel_t *pick_next(struct ssd1306_group_t *g, group_bus_t *bus,
+                                int64_t *req_us, int64_t *deadline_us) {
+    group_panel_t *best     = NULL;
+    size_t         best_len = 0;
+    bool           best_sel = false;
+
+    portENTER_CRITICAL(&g->spin);
+    int64_t earliest = INT64_MAX;
+    for (int i = 0; i < g->n_panels; ++i) {
+        group_panel_t *p = &g->panel[i];
+        if (p->bus == bus && p->pending && p->deadline_us < earliest)
+            earliest = p->deadline_us;
+    }
+    for (int i = 0; i < g->n_panels; ++i) {
+        group_panel_t *p = &g->panel[i];
+        if (p->bus != bus || !p->pending ||
+            p->deadline_us > earliest + GROUP_SLACK_US)
+            continue;
+        const size_t len = ssd1306_dirty_bytes(p->d);
+        const bool   sel = !p->d->vt->selected ||
+                         p->d->vt->selected(p->d->bus_ctx);
+        if (!best || (sel && !best_sel) ||
+            (sel == best_sel && len < best_len)) {
+            best     = p;
+            best_len = len;
+            best_sel = sel;
+        }
+    }
+    if (best) {
+        best->pending = false;
+        *req_us       = best->req_us;
+        *deadline_us  = best->deadline_us;
+    }
+    portEXIT_CRITICAL(&g->spin);
+    return best;
+}
+
+static void record_flush(struct ssd1306_group_t *g, group_panel_t *p,
+                         int64_t req_us, int64_t deadline_us, int64_t start_us,
+                         int64_t end_us) {
+    const uint32_t queue_us = (uint32_t)(start_us - req_us);
+
+    portENTER_CRITICAL(&g->spin);
+    p->st.flushes++;
+    p->st.queue_us_last = queue_us;
+    if (queue_us > p->st.queue_us_max)
+        p->st.queue_us_max = queue_us;
+    if (end_us > deadline_us)
+        p->st.deadline_misses++;
+
+    p->win_flushes++;
+    const int64_t win = end_us - p->win_start_us;
+    if (win >= GROUP_FPS_WINDOW_US) {
+        p->st.fps       = (float)p->win_flushes * 1e6f / (float)win;
+        p->win_flushes  = 0;
+        p->win_start_us = end_us;
+    }
+    portEXIT_CRITICAL(&g->spin);
+}
+
+static void bus_task(void *arg) {
+    group_bus_t            *bus = arg;
+    struct ssd1306_group_t *g   = bus->g;
+
+    while (!g->stop) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // Keep the bus busy back to back while anything is pending on it.
+        group_panel_t *p;
+        int64_t        req_us, deadline_us;
+        while (!g->stop &&
+               (p = pick_next(g, bus, &req_us, &deadline_us)) != NULL) {
+            const int64_t start_us = esp_timer_get_time();
+            esp_err_t     err      = ssd1306_display(p->d);
+            if (err != ESP_OK)
+                ESP_LOGW(TAG, "flush failed: %s", esp_err_to_name(err));
+            record_flush(g, p, req_us, deadline_us, start_us,
+                         esp_timer_get_time());
+        }
+    }
+
+    xSemaphoreGive(g->done);
+    vTaskDelete(NULL);
+}
+
+static group_panel_t *find_panel(struct ssd1306_group_t *g,
+                                 ssd1306_handle_t        h) {
+    for (int i = 0; i < g->n_panels; ++i) {
+        if (g->panel[i].d == h)
+            return &g->panel[i];
+    }
+    return NULL;
+}
+
+esp_err_t ssd1306_group_new(const ssd1306_group_cfg_t *cfg,
+                            ssd1306_group_handle_t    *out) {
+    ESP_RETURN_ON_FALSE(out, ESP_ERR_INVALID_ARG, TAG, "out=NULL");
+
+    struct ssd1306_group_t *g = calloc(1, sizeof(*g));
+    ESP_RETURN_ON_FALSE(g, ESP_ERR_NO_MEM, TAG, "no mem");
+    g->done = xSemaphoreCreateCounting(SSD1306_GROUP_MAX_PANELS, 0);
+    if (!g->done) {
+        free(g);
+        return ESP_ERR_NO_MEM;
+    }
+    portMUX_INITIALIZE(&g->spin);
+
+    const ssd1306_group_cfg_t def = {0};
+    if (!cfg)
+        cfg = &def;
+    g->default_deadline_us =
+        (cfg->default_deadline_ms ? cfg->default_deadline_ms
+                                  : GROUP_DEFAULT_DEADLINE) *
+        1000u;
+    g->stack_size = cfg->stack_size ? cfg->stack_size : GROUP_DEFAULT_STACK;
+    g->priority   = cfg->priority ? cfg->priority : GROUP_DEFAULT_PRIO;
+
+    *out          = g;
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_group_add(ssd1306_group_handle_t g, ssd1306_handle_t h) {
+    ESP_RETURN_ON_FALSE(g && h, ESP_ERR_INVALID_ARG, TAG, "null arg");
+    ESP_RETURN_ON_FALSE(!find_panel(g, h), ESP_ERR_INVALID_STATE, TAG,
+                        "already in group");
+    ESP_RETURN_ON_FALSE(g->n_panels < SSD1306_GROUP_MAX_PANELS, ESP_ERR_NO_MEM,
+                        TAG, "group full");
+
+    struct ssd1306_t *d   = h;
+    group_bus_t      *bus = NULL;
+    for (int i = 0; i < g->n_buses; ++i) {
+        if (g->bus[i].key == d->bus_key)
+            bus = &g->bus[i];
+    }
+    if (!bus) {
+        bus      = &g->bus[g->n_buses];
+        bus->g   = g;
+        bus->key = d->bus_key;
+        if (xTaskCreate(bus_task, "ssd1306_group", g->stack_size, bus,
+                        g->priority, &bus->task) != pdPASS)
+            return ESP_ERR_NO_MEM;
+        g->n_buses++;
+    }
+
+    group_panel_t *p = &g->panel[g->n_panels++];
+    memset(p, 0, sizeof(*p));
+    p->d            = d;
+    p->bus          = bus;
+    p->win_start_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_group_request(ssd1306_group_handle_t g, ssd1306_handle_t h,
+                                uint32_t deadline_ms) {
+    ESP_RETURN_ON_FALSE(g && h, ESP_ERR_INVALID_ARG, TAG, "null arg");
+    group_panel_t *p = find_panel(g, h);
+    ESP_RETURN_ON_FALSE(p, ESP_ERR_NOT_FOUND, TAG, "not in group");
+
+    const int64_t now = esp_timer_get_time();
+    const int64_t deadline =
+        now + (deadline_ms ? (int64_t)deadline_ms * 1000
+                           : (int64_t)g->default_deadline_us);
+
+    // Coalesce with a pending request, keeping the earlier deadline.
+    portENTER_CRITICAL(&g->spin);
+    if (!p->pending) {
+        p->pending     = true;
+        p->req_us      = now;
+        p->deadline_us = deadline;
+    } else if (deadline < p->deadline_us) {
+        p->deadline_us = deadline;
+    }
+    portEXIT_CRITICAL(&g->spin);
+
+    xTaskNotifyGive(p->bus->task);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_group_get_stats(ssd1306_group_handle_t g, ssd1306_handle_t h,
+                                  ssd1306_group_stats_t *out) {
+    ESP_RETURN_ON_FALSE(g && h && out, ESP_ERR_INVALID_ARG, TAG, "null arg");
+    group_panel_t *p = find_panel(g, h);
+    ESP_RETURN_ON_FALSE(p, ESP_ERR_NOT_FOUND, TAG, "not in group");
+
+    portENTER_CRITICAL(&g->spin);
+    *out = p->st;
+    portEXIT_CRITICAL(&g->spin);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_group_del(ssd1306_group_handle_t g) {
+    ESP_RETURN_ON_FALSE(g, ESP_ERR_INVALID_ARG, TAG, "null arg");
+
+    g->stop = true;
+    for (int i = 0; i < g->n_buses; ++i)
+        xTaskNotifyGive(g->bus[i].task);
+    for (int i = 0; i < g->n_buses; ++i)
+        xSemaphoreTake(g->done, portMAX_DELAY);
+
+    vSemaphoreDelete(g->done);
+    free(g);
+    return ESP_OK;
+}
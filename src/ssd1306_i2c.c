@@ -7,58 +7,331 @@
 #include "ssd1306_private.h"
 
 #include <driver/gpio.h>
+#include <esp_attr.h>
 #include <esp_check.h>
 #include <esp_log.h>
+#include <soc/soc_caps.h>
+#include <stdatomic.h>
 
 #define SSD1306_CTRL_CMD  0x00
 #define SSD1306_CTRL_DATA 0x40
+#define MUX_CHANNELS      8
+#define MUX_NONE          (-1)
+#define ASYNC_CHUNK       256 // payload per queued transaction
+#define ASYNC_SLOT        (1 + ASYNC_CHUNK)
 
 static const char *TAG = "SSD1306_I2C";
 
-typedef struct {
+// TCA9548A-style mux: one control byte, bit n enables channel n. The lock is
+// recursive so a flush can hold the channel while sending its transactions.
+struct ssd1306_i2c_mux_t {
+    i2c_master_bus_handle_t bus;
     i2c_master_dev_handle_t dev;
-    i2c_port_num_t          port;
-    gpio_num_t              rst_gpio;
-    uint8_t                 addr;
+    SemaphoreHandle_t       lock;
+    uint8_t                 sel; // select byte; outlives a queued write
+    int                     channel; // selected channel, MUX_NONE if unknown
+    uint32_t                users;   // displays bound behind the mux
+};
+
+// Async mode: each transaction is copied into a slot behind its control byte
+// and queued. The driver completes them in order, so slots are reused round
+// robin; on_trans_done hands them back.
+typedef struct {
+    uint8_t          *pool; // depth slots of ASYNC_SLOT bytes
+    SemaphoreHandle_t free; // free slots
+    atomic_uint       inflight;
+    atomic_int        err; // first failure reported by the driver
+    uint8_t           depth;
+    uint8_t           next; // slot to fill next
+    void (*on_idle)(void *arg);
+    void *on_idle_arg;
+} i2c_async_t;
+
+typedef struct {
+    i2c_master_dev_handle_t   dev;
+    struct ssd1306_i2c_mux_t *mux;
+    i2c_async_t              *async; // NULL for blocking writes
+    int                       timeout_ms; // per transaction
+    i2c_port_num_t            port;
+    gpio_num_t                rst_gpio;
+    uint8_t                   addr;
+    uint8_t                   mux_channel;
 } ssd1306_i2c_ctx_t;
 
+SSD1306_STATIC_CTX_CHECK(ssd1306_i2c_ctx_t);
+
 // Forward declarations
 static esp_err_t i2c_send_cmd(void *ctx, const uint8_t *cmd, size_t n);
 static esp_err_t i2c_send_data(void *ctx, const uint8_t *data, size_t n);
+static esp_err_t i2c_send_data_inplace(void *ctx, uint8_t *data, size_t n);
 static esp_err_t i2c_reset(void *ctx);
+static esp_err_t i2c_begin(void *ctx);
+static esp_err_t i2c_end(void *ctx);
+static bool      i2c_selected(void *ctx);
+static esp_err_t i2c_async_send_cmd(void *ctx, const uint8_t *cmd, size_t n);
+static esp_err_t i2c_async_send_data(void *ctx, const uint8_t *data,
+                                     size_t n);
+static esp_err_t i2c_wait_idle(void *ctx, TickType_t timeout);
+static esp_err_t i2c_recover(void *ctx);
 
 static const ssd1306_bus_vt_t VT_I2C = {
-    .send_cmd  = i2c_send_cmd,
-    .send_data = i2c_send_data,
+    .send_cmd          = i2c_send_cmd,
+    .send_data         = i2c_send_data,
+    .send_data_inplace = i2c_send_data_inplace,
+    .reset             = i2c_reset,
+    .begin             = i2c_begin,
+    .end               = i2c_end,
+    .selected          = i2c_selected,
+    .recover           = i2c_recover,
+};
+
+static const ssd1306_bus_vt_t VT_I2C_ASYNC = {
+    .send_cmd  = i2c_async_send_cmd,
+    .send_data = i2c_async_send_data,
     .reset     = i2c_reset,
+    .begin     = i2c_begin,
+    .end       = i2c_end,
+    .selected  = i2c_selected,
+    .wait_idle = i2c_wait_idle,
+    .recover   = i2c_recover,
 };
 
-esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, i2c_port_num_t port,
-                           uint8_t addr, gpio_num_t rst_gpio) {
-    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
+esp_err_t ssd1306_i2c_mux_new(i2c_port_num_t port, uint8_t addr,
+                              ssd1306_i2c_mux_handle_t *out) {
+    ESP_RETURN_ON_FALSE(out, ESP_ERR_INVALID_ARG, TAG, "out=NULL");
 
     i2c_master_bus_handle_t bus = NULL;
     ESP_RETURN_ON_ERROR(i2c_master_get_bus_handle(port, &bus), TAG,
                         "I2C port %d not initialized", port);
 
-    ssd1306_i2c_ctx_t *ctx = calloc(1, sizeof(*ctx));
-    ESP_RETURN_ON_FALSE(ctx, ESP_ERR_NO_MEM, TAG, "no mem");
-    ctx->port                   = port;
-    ctx->addr                   = addr;
-    ctx->rst_gpio               = rst_gpio;
+    struct ssd1306_i2c_mux_t *m = calloc(1, sizeof(*m));
+    ESP_RETURN_ON_FALSE(m, ESP_ERR_NO_MEM, TAG, "no mem");
+    m->bus     = bus;
+    m->channel = MUX_NONE;
+    m->lock    = xSemaphoreCreateRecursiveMutex();
+    if (!m->lock) {
+        free(m);
+        return ESP_ERR_NO_MEM;
+    }
 
     i2c_device_config_t dev_cfg = {
         .device_address = addr,
         .scl_speed_hz   = 400000,
+    };
+    esp_err_t err = i2c_master_bus_add_device(bus, &dev_cfg, &m->dev);
+    if (err != ESP_OK) {
+        vSemaphoreDelete(m->lock);
+        free(m);
+        return err;
+    }
+
+    *out = m;
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_i2c_mux_del(ssd1306_i2c_mux_handle_t m) {
+    ESP_RETURN_ON_FALSE(m, ESP_ERR_INVALID_ARG, TAG, "null mux");
+    ESP_RETURN_ON_FALSE(!m->users, ESP_ERR_INVALID_STATE, TAG,
+                        "%lu display(s) still bound", (unsigned long)m->users);
+
+    esp_err_t err = i2c_master_bus_rm_device(m->dev);
+    vSemaphoreDelete(m->lock);
+    free(m);
+    return err;
+}
+
+// Panels bound per port, by mode. A bus created with trans_queue_depth (as
+// async_depth requires) makes every write on it asynchronous, so blocking
+// panels, which send from stack buffers or frame in place, cannot share it.
+typedef struct {
+    uint8_t blocking;
+    uint8_t async;
+} i2c_port_users_t;
+
+static i2c_port_users_t s_port_users[SOC_I2C_NUM];
+static portMUX_TYPE     s_port_spin = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_err_t port_claim(i2c_port_num_t port, bool async) {
+    i2c_port_users_t *u   = &s_port_users[port];
+    esp_err_t         err = ESP_OK;
+    portENTER_CRITICAL(&s_port_spin);
+    if (async ? u->blocking : u->async)
+        err = ESP_ERR_INVALID_STATE;
+    else if (async)
+        u->async++;
+    else
+        u->blocking++;
+    portEXIT_CRITICAL(&s_port_spin);
+    return err;
+}
+
+static void port_release(i2c_port_num_t port, bool async) {
+    portENTER_CRITICAL(&s_port_spin);
+    if (async)
+        s_port_users[port].async--;
+    else
+        s_port_users[port].blocking--;
+    portEXIT_CRITICAL(&s_port_spin);
+}
+
+// Take the mux and switch it to this display's channel unless it is already
+// there. No-op for displays wired directly to the bus. Waiting for the mux is
+// bounded by the transfer timeout, so a panel stuck behind another one's
+// flush goes through the link-down path like any failed transfer.
+static esp_err_t mux_acquire(ssd1306_i2c_ctx_t *c) {
+    struct ssd1306_i2c_mux_t *m = c->mux;
+    if (!m)
+        return ESP_OK;
+
+    if (xSemaphoreTakeRecursive(m->lock, pdMS_TO_TICKS(c->timeout_ms)) !=
+        pdTRUE) {
+        ESP_LOGE(TAG, "mux busy for channel %u", c->mux_channel);
+        return ESP_ERR_TIMEOUT;
+    }
+    if (m->channel == c->mux_channel)
+        return ESP_OK;
+
+    // On an async bus the previous select may still be queued; let it and
+    // the previous channel's data go out first.
+    esp_err_t err = i2c_master_bus_wait_all_done(m->bus, c->timeout_ms);
+    if (err == ESP_OK) {
+        m->sel = 1u << c->mux_channel;
+        err    = i2c_master_transmit(m->dev, &m->sel, 1, c->timeout_ms);
+    }
+    if (err != ESP_OK) {
+        m->channel = MUX_NONE;
+        xSemaphoreGiveRecursive(m->lock);
+        ESP_LOGE(TAG, "mux select %u failed: %s", c->mux_channel,
+                 esp_err_to_name(err));
+        return err;
+    }
+    m->channel = c->mux_channel;
+    return ESP_OK;
+}
+
+static void mux_release(ssd1306_i2c_ctx_t *c) {
+    if (c->mux)
+        xSemaphoreGiveRecursive(c->mux->lock);
+}
+
+static void async_free(struct ssd1306_t *d, i2c_async_t *a) {
+    if (!a)
+        return;
+    if (a->free)
+        vSemaphoreDelete(a->free);
+    ssd1306_buf_free(d, SSD1306_BUF_XFER, a->pool);
+    free(a);
+}
+
+static i2c_async_t *async_new(struct ssd1306_t        *d,
+                              const ssd1306_i2c_cfg_t *cfg) {
+    i2c_async_t *a = calloc(1, sizeof(*a));
+    if (!a)
+        return NULL;
+    a->depth       = cfg->async_depth;
+    a->on_idle     = cfg->on_idle;
+    a->on_idle_arg = cfg->on_idle_arg;
+    a->free        = xSemaphoreCreateCounting(a->depth, a->depth);
+    a->pool        = ssd1306_buf_alloc(d, SSD1306_BUF_XFER,
+                                       (size_t)a->depth * ASYNC_SLOT);
+    if (!a->free || !a->pool) {
+        async_free(d, a);
+        return NULL;
+    }
+    return a;
+}
+
+// A queued transaction finished (ISR context)
+static bool IRAM_ATTR async_done(i2c_master_dev_handle_t        dev,
+                                 const i2c_master_event_data_t *evt,
+                                 void                          *arg) {
+    i2c_async_t *a     = arg;
+    BaseType_t   woken = pdFALSE;
+    if (evt->event != I2C_EVENT_DONE) {
+        int none = ESP_OK;
+        atomic_compare_exchange_strong(&a->err, &none, ESP_FAIL);
+    }
+    xSemaphoreGiveFromISR(a->free, &woken);
+    if (atomic_fetch_sub(&a->inflight, 1) == 1 && a->on_idle)
+        a->on_idle(a->on_idle_arg);
+    return woken == pdTRUE;
+}
+
+// Register the panel on the bus (and the async completion callback)
+static esp_err_t add_device(ssd1306_i2c_ctx_t *c, i2c_master_bus_handle_t bus) {
+    i2c_device_config_t dev_cfg = {
+        .device_address = c->addr,
+        .scl_speed_hz   = 400000,
         .scl_wait_us    = 0,
         .flags =
             {
                 .disable_ack_check = 0,
             },
     };
-    esp_err_t err = i2c_master_bus_add_device(bus, &dev_cfg, &ctx->dev);
+    ESP_RETURN_ON_ERROR(i2c_master_bus_add_device(bus, &dev_cfg, &c->dev), TAG,
+                        "add device");
+    if (!c->async)
+        return ESP_OK;
+
+    const i2c_master_event_callbacks_t cbs = {.on_trans_done = async_done};
+    esp_err_t err = i2c_master_register_event_callbacks(c->dev, &cbs, c->async);
     if (err != ESP_OK) {
-        free(ctx);
+        ESP_LOGE(TAG, "async setup failed: %s", esp_err_to_name(err));
+        (void)i2c_master_bus_rm_device(c->dev);
+        c->dev = NULL;
+    }
+    return err;
+}
+
+esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, const ssd1306_i2c_cfg_t *cfg) {
+    ESP_RETURN_ON_FALSE(d && cfg, ESP_ERR_INVALID_ARG, TAG, "null arg");
+    ESP_RETURN_ON_FALSE(!cfg->mux || cfg->mux_channel < MUX_CHANNELS,
+                        ESP_ERR_INVALID_ARG, TAG, "bad mux channel %u",
+                        cfg->mux_channel);
+    ESP_RETURN_ON_FALSE(!cfg->async_depth || !d->static_mem,
+                        ESP_ERR_NOT_SUPPORTED, TAG,
+                        "async I2C allocates; not for static handles");
+
+    const i2c_port_num_t           port     = cfg->port;
+    const uint8_t                  addr     = cfg->addr;
+    gpio_num_t                     rst_gpio = cfg->rst_gpio;
+    const ssd1306_i2c_mux_handle_t mux      = cfg->mux;
+
+    i2c_master_bus_handle_t bus = NULL;
+    ESP_RETURN_ON_ERROR(i2c_master_get_bus_handle(port, &bus), TAG,
+                        "I2C port %d not initialized", port);
+    ESP_RETURN_ON_FALSE((unsigned)port < SOC_I2C_NUM, ESP_ERR_INVALID_ARG, TAG,
+                        "bad I2C port %d", port);
+    ESP_RETURN_ON_ERROR(port_claim(port, cfg->async_depth), TAG,
+                        "I2C port %d has %s panels; all panels on a bus "
+                        "must agree on async_depth",
+                        port, cfg->async_depth ? "blocking" : "async");
+
+    ssd1306_i2c_ctx_t *ctx = ssd1306_ctx_alloc(d, sizeof(*ctx));
+    if (!ctx) {
+        port_release(port, cfg->async_depth);
+        ESP_LOGE(TAG, "no mem");
+        return ESP_ERR_NO_MEM;
+    }
+    ctx->port        = port;
+    ctx->addr        = addr;
+    ctx->rst_gpio    = rst_gpio;
+    ctx->mux         = mux;
+    ctx->mux_channel = cfg->mux_channel;
+    ctx->timeout_ms  = (int)d->xfer_timeout_ms;
+
+    esp_err_t err    = ESP_OK;
+    if (cfg->async_depth) {
+        ctx->async = async_new(d, cfg);
+        if (!ctx->async)
+            err = ESP_ERR_NO_MEM;
+    }
+    if (err == ESP_OK)
+        err = add_device(ctx, bus);
+    if (err != ESP_OK) {
+        async_free(d, ctx->async);
+        ssd1306_ctx_free(d, ctx);
+        port_release(port, cfg->async_depth);
         return err;
     }
 
@@ -70,9 +343,9 @@ esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, i2c_port_num_t port,
             .pull_down_en = GPIO_PULLDOWN_DISABLE,
             .intr_type    = GPIO_INTR_DISABLE,
         };
-        if (gpio_config(&io) == ESP_OK) {
-            gpio_set_level(rst_gpio, 1);
-        } else {
+        // Latch high first: a low blip would reset the panel.
+        gpio_set_level(rst_gpio, 1);
+        if (gpio_config(&io) != ESP_OK) {
             ESP_LOGW(TAG,
                      "rst_gpio %d config failed; continuing without HW reset",
                      rst_gpio);
@@ -80,8 +353,23 @@ esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, i2c_port_num_t port,
         }
     }
 
-    d->vt      = &VT_I2C;
+    if (mux) {
+        xSemaphoreTakeRecursive(mux->lock, portMAX_DELAY);
+        mux->users++;
+        xSemaphoreGiveRecursive(mux->lock);
+    }
+
+    d->vt      = ctx->async ? &VT_I2C_ASYNC : &VT_I2C;
     d->bus_ctx = ctx;
+    d->bus     = SSD1306_I2C;
+    d->bus_key = SSD1306_BUS_KEY(SSD1306_I2C, port);
+    // Defaults unless configured: 9 clocks per byte at 400 kHz; start,
+    // address, control byte and stop plus driver setup per transaction.
+    if (!d->cost.byte_ns) {
+        d->cost.setup_ns = 100000;
+        d->cost.byte_ns  = 22500;
+        d->cost.cmd_ns   = 7 * 22500 + 100000;
+    }
 
     return ESP_OK;
 }
@@ -89,7 +377,9 @@ esp_err_t ssd1306_bind_i2c(struct ssd1306_t *d, i2c_port_num_t port,
 static esp_err_t i2c_send_cmd(void *ctx, const uint8_t *cmds, size_t n) {
     if (!n)
         return ESP_OK;
-    ssd1306_i2c_ctx_t *c = ctx;
+    ssd1306_i2c_ctx_t *c   = ctx;
+    esp_err_t          ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(mux_acquire(c), TAG, "mux");
 
     // control + payload on stack for a single burst
     const size_t MAX = 32; // payload per burst
@@ -99,45 +389,199 @@ static esp_err_t i2c_send_cmd(void *ctx, const uint8_t *cmds, size_t n) {
         uint8_t buf[1 + MAX];
         buf[0] = SSD1306_CTRL_CMD;
         memcpy(&buf[1], &cmds[off], blk);
-        ESP_RETURN_ON_ERROR(i2c_master_transmit(c->dev, buf, 1 + blk, -1), TAG,
-                            "cmd xfer");
+        ESP_GOTO_ON_ERROR(
+            i2c_master_transmit(c->dev, buf, 1 + blk, c->timeout_ms), out, TAG,
+            "cmd xfer");
         off += blk;
     }
-    return ESP_OK;
+out:
+    mux_release(c);
+    return ret;
 }
 
 static esp_err_t i2c_send_data(void *ctx, const uint8_t *data, size_t n) {
     if (!n)
         return ESP_OK;
     ssd1306_i2c_ctx_t *c   = ctx;
+    esp_err_t          ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(mux_acquire(c), TAG, "mux");
 
-    const size_t       MAX = 32; // payload per burst
-    size_t             off = 0;
+    const size_t MAX = 32; // payload per burst
+    size_t       off = 0;
 
     while (off < n) {
         size_t  blk = (n - off) > MAX ? MAX : (n - off);
         uint8_t buf[1 + MAX];
         buf[0] = SSD1306_CTRL_DATA;
         memcpy(&buf[1], &data[off], blk);
-        ESP_RETURN_ON_ERROR(i2c_master_transmit(c->dev, buf, 1 + blk, -1), TAG,
-                            "data xfer");
+        ESP_GOTO_ON_ERROR(
+            i2c_master_transmit(c->dev, buf, 1 + blk, c->timeout_ms), out, TAG,
+            "data xfer");
         off += blk;
     }
+out:
+    mux_release(c);
+    return ret;
+}
 
+// Flush data from the stage or a pipeline slot: the control byte goes into the
+// headroom byte in front of the run, so the whole run is one transaction with
+// no copy. The borrowed byte belongs to the previous page row (or is the
+// buffer's spare byte) and is put back afterwards.
+static esp_err_t i2c_send_data_inplace(void *ctx, uint8_t *data, size_t n) {
+    if (!n)
+        return ESP_OK;
+    ssd1306_i2c_ctx_t *c   = ctx;
+    esp_err_t          ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(mux_acquire(c), TAG, "mux");
+
+    uint8_t *frame = data - 1;
+    uint8_t  saved = *frame;
+    *frame         = SSD1306_CTRL_DATA;
+    ret            = i2c_master_transmit(c->dev, frame, 1 + n, c->timeout_ms);
+    *frame         = saved;
+    if (ret != ESP_OK)
+        ESP_LOGE(TAG, "data xfer: %s", esp_err_to_name(ret));
+
+    mux_release(c);
+    return ret;
+}
+
+// Copy n bytes behind ctrl into free slots and queue them, waiting only when
+// all slots are in flight. Reports a failure of an earlier transaction.
+static esp_err_t async_queue(ssd1306_i2c_ctx_t *c, uint8_t ctrl,
+                             const uint8_t *src, size_t n) {
+    i2c_async_t *a   = c->async;
+    esp_err_t    ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(mux_acquire(c), TAG, "mux");
+
+    while (n) {
+        const size_t blk = n > ASYNC_CHUNK ? ASYNC_CHUNK : n;
+        if (xSemaphoreTake(a->free, pdMS_TO_TICKS(c->timeout_ms)) != pdTRUE) {
+            ret = ESP_ERR_TIMEOUT;
+            ESP_LOGE(TAG, "queued xfers not completing");
+            break;
+        }
+        ret = atomic_exchange(&a->err, ESP_OK);
+        if (ret != ESP_OK) {
+            xSemaphoreGive(a->free);
+            ESP_LOGE(TAG, "queued xfer failed");
+            break;
+        }
+
+        uint8_t *slot = &a->pool[(size_t)a->next * ASYNC_SLOT];
+        a->next       = (uint8_t)((a->next + 1) % a->depth);
+        slot[0]       = ctrl;
+        memcpy(&slot[1], src, blk);
+        atomic_fetch_add(&a->inflight, 1);
+        ret = i2c_master_transmit(c->dev, slot, 1 + blk, c->timeout_ms);
+        if (ret != ESP_OK) {
+            atomic_fetch_sub(&a->inflight, 1);
+            xSemaphoreGive(a->free);
+            ESP_LOGE(TAG, "queue xfer: %s", esp_err_to_name(ret));
+            break;
+        }
+        src += blk;
+        n -= blk;
+    }
+    mux_release(c);
+    return ret;
+}
+
+static esp_err_t i2c_async_send_cmd(void *ctx, const uint8_t *cmds, size_t n) {
+    return async_queue(ctx, SSD1306_CTRL_CMD, cmds, n);
+}
+
+static esp_err_t i2c_async_send_data(void *ctx, const uint8_t *data,
+                                     size_t n) {
+    return async_queue(ctx, SSD1306_CTRL_DATA, data, n);
+}
+
+// Every slot back means nothing is in flight.
+static esp_err_t i2c_wait_idle(void *ctx, TickType_t timeout) {
+    ssd1306_i2c_ctx_t *c = ctx;
+    i2c_async_t       *a = c->async;
+    if (!a)
+        return ESP_OK;
+
+    const TickType_t start = xTaskGetTickCount();
+    int              taken = 0;
+    while (taken < a->depth) {
+        TickType_t left = timeout;
+        if (timeout != portMAX_DELAY) {
+            const TickType_t spent = xTaskGetTickCount() - start;
+            left                   = spent < timeout ? timeout - spent : 0;
+        }
+        if (xSemaphoreTake(a->free, left) != pdTRUE)
+            break;
+        taken++;
+    }
+    for (int i = 0; i < taken; ++i)
+        xSemaphoreGive(a->free);
+    if (taken < a->depth)
+        return ESP_ERR_TIMEOUT;
+    return atomic_exchange(&a->err, ESP_OK);
+}
+
+// A flush selects the channel once and keeps the mux until it is done, so
+// other panels behind the mux cannot switch it away mid-frame.
+static esp_err_t i2c_begin(void *ctx) { return mux_acquire(ctx); }
+
+static esp_err_t i2c_end(void *ctx) {
+    mux_release(ctx);
     return ESP_OK;
 }
 
+static bool i2c_selected(void *ctx) {
+    ssd1306_i2c_ctx_t *c = ctx;
+    return !c->mux || c->mux->channel == c->mux_channel;
+}
+
+// After failed transfers: drop the device, free a stuck bus (clock pulses)
+// and register the device again. Anything still queued is abandoned.
+static esp_err_t i2c_recover(void *ctx) {
+    ssd1306_i2c_ctx_t      *c   = ctx;
+    i2c_master_bus_handle_t bus = NULL;
+    ESP_RETURN_ON_ERROR(i2c_master_get_bus_handle(c->port, &bus), TAG,
+                        "I2C port %d gone", c->port);
+
+    if (c->async)
+        (void)i2c_wait_idle(c, pdMS_TO_TICKS(c->timeout_ms));
+    if (c->dev) {
+        (void)i2c_master_bus_rm_device(c->dev);
+        c->dev = NULL;
+    }
+    esp_err_t err = i2c_master_bus_reset(bus);
+    if (err != ESP_OK)
+        ESP_LOGW(TAG, "bus reset: %s", esp_err_to_name(err));
+
+    i2c_async_t *a = c->async;
+    if (a) {
+        // No callbacks can arrive for the removed device: all slots are free.
+        while (uxSemaphoreGetCount(a->free) < a->depth)
+            xSemaphoreGive(a->free);
+        atomic_store(&a->inflight, 0);
+        atomic_store(&a->err, ESP_OK);
+        a->next = 0;
+    }
+    if (c->mux) {
+        // The mux may have lost its state too.
+        if (xSemaphoreTakeRecursive(c->mux->lock,
+                                    pdMS_TO_TICKS(c->timeout_ms)) != pdTRUE)
+            return ESP_ERR_TIMEOUT;
+        c->mux->channel = MUX_NONE;
+        xSemaphoreGiveRecursive(c->mux->lock);
+    }
+    return add_device(c, bus);
+}
+
 static esp_err_t i2c_reset(void *ctx) {
     ssd1306_i2c_ctx_t *c = ctx;
 
     if (c->rst_gpio == GPIO_NUM_NC)
         return ESP_OK;
 
-    gpio_set_level(c->rst_gpio, 0);
-    vTaskDelay(pdMS_TO_TICKS(10));
-    gpio_set_level(c->rst_gpio, 1);
-    vTaskDelay(pdMS_TO_TICKS(10));
-
+    ssd1306_reset_pulse(c->rst_gpio);
     return ESP_OK;
 }
 
@@ -148,6 +592,15 @@ esp_err_t ssd1306_unbind_i2c(struct ssd1306_t *d) {
     ssd1306_i2c_ctx_t *ctx = (ssd1306_i2c_ctx_t *)d->bus_ctx;
     esp_err_t          ret = ESP_OK;
 
+    // Queued transactions read from the slots
+    if (ctx->async) {
+        (void)i2c_wait_idle(ctx, portMAX_DELAY);
+        if (ctx->dev) {
+            const i2c_master_event_callbacks_t none = {0};
+            (void)i2c_master_register_event_callbacks(ctx->dev, &none, NULL);
+        }
+    }
+
     if (ctx->dev) {
         esp_err_t e = i2c_master_bus_rm_device(ctx->dev);
         if (e != ESP_OK) {
@@ -170,7 +623,15 @@ esp_err_t ssd1306_unbind_i2c(struct ssd1306_t *d) {
         (void)gpio_config(&io);
     }
 
-    free(ctx);
+    if (ctx->mux) {
+        xSemaphoreTakeRecursive(ctx->mux->lock, portMAX_DELAY);
+        ctx->mux->users--;
+        xSemaphoreGiveRecursive(ctx->mux->lock);
+    }
+
+    port_release(ctx->port, ctx->async != NULL);
+    async_free(d, ctx->async);
+    ssd1306_ctx_free(d, ctx);
     d->bus_ctx = NULL;
     d->vt      = NULL;
 
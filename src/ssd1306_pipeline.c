@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: MIT
+/*
+ * ssd1306_pipeline.c - Render/flush pipeline with a pinned flush task
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ */
+
+#include "ssd1306_private.h"
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
+
+#define PIPE_DEFAULT_STACK 3072
+#define PIPE_DEFAULT_PRIO  6
+#define PIPE_SLOTS         3
+#define PIPE_SLOT_MASK     0x3u
+#define PIPE_SLOT_NEW      0x4u // published frame not yet taken by flusher
+
+static const char *TAG = "SSD1306_PIPE";
+
+// Triple buffer handoff between display() callers and the flush task.
+//   back   filled by the producer, owned by it
+//   ready  latest published frame (| PIPE_SLOT_NEW until taken)
+//   front  frame being transmitted, owned by the flush task
+// Each slot carries the region it holds; a frame replaced before the flush
+// task took it has its region merged into the next one.
+struct ssd1306_pipe_t {
+    uint8_t          *buf[PIPE_SLOTS];
+    ssd1306_box_t     box[PIPE_SLOTS];
+    atomic_uint       ready;
+    uint8_t           back;
+    uint8_t           front;
+
+    TaskHandle_t      task;
+    SemaphoreHandle_t submit; // serializes producers
+    SemaphoreHandle_t done;   // given by the flush task on exit
+    volatile bool     stop;
+};
+
+esp_err_t ssd1306_pipeline_submit(struct ssd1306_t *d) {
+    struct ssd1306_pipe_t *p = d->pipe;
+
+    if (!ssd1306_take(d, p->submit, d->lock_timeout, xTaskGetTickCount()))
+        return ESP_ERR_TIMEOUT;
+
+    // If the last frame is still unsent, this one must cover its region too.
+    ssd1306_box_t box = SSD1306_BOX_EMPTY;
+    unsigned      cur = atomic_load_explicit(&p->ready, memory_order_acquire);
+    if (cur & PIPE_SLOT_NEW)
+        box = p->box[cur & PIPE_SLOT_MASK];
+
+    esp_err_t err = ssd1306_snapshot(d, p->buf[p->back], &box);
+    if (err != ESP_OK || ssd1306_box_empty(&box)) {
+        xSemaphoreGive(p->submit);
+        return err;
+    }
+    p->box[p->back] = box;
+
+    unsigned prev = atomic_exchange_explicit(
+        &p->ready, p->back | PIPE_SLOT_NEW, memory_order_acq_rel);
+    p->back       = prev & PIPE_SLOT_MASK;
+    if (prev & PIPE_SLOT_NEW) {
+        portENTER_CRITICAL(&d->spin);
+        d->stats.frames_merged++;
+        portEXIT_CRITICAL(&d->spin);
+    }
+
+    xSemaphoreGive(p->submit);
+    xTaskNotifyGive(p->task);
+    return ESP_OK;
+}
+
+static void flush_task(void *arg) {
+    struct ssd1306_t      *d = arg;
+    struct ssd1306_pipe_t *p = d->pipe;
+
+    while (!p->stop) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        while (!p->stop && (atomic_load_explicit(&p->ready,
+                                                 memory_order_acquire) &
+                            PIPE_SLOT_NEW)) {
+            unsigned prev = atomic_exchange_explicit(&p->ready, p->front,
+                                                     memory_order_acq_rel);
+            p->front      = prev & PIPE_SLOT_MASK;
+
+            xSemaphoreTake(d->flush_lock, portMAX_DELAY);
+            esp_err_t err =
+                ssd1306_send_rows(d, p->buf[p->front], &p->box[p->front]);
+            xSemaphoreGive(d->flush_lock);
+            if (err != ESP_OK)
+                ESP_LOGW(TAG, "flush failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    xSemaphoreGive(p->done);
+    vTaskDelete(NULL);
+}
+
+static void pipe_free(struct ssd1306_t *d, struct ssd1306_pipe_t *p) {
+    if (p->submit)
+        vSemaphoreDelete(p->submit);
+    if (p->done)
+        vSemaphoreDelete(p->done);
+    for (int i = 0; i < PIPE_SLOTS; ++i)
+        ssd1306_buf_free(d, SSD1306_BUF_PIPE, p->buf[i]);
+    free(p);
+}
+
+esp_err_t ssd1306_pipeline_start(ssd1306_handle_t              h,
+                                 const ssd1306_pipeline_cfg_t *cfg) {
+    struct ssd1306_t *d = h;
+    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
+    ESP_RETURN_ON_FALSE(!d->pipe, ESP_ERR_INVALID_STATE, TAG,
+                        "already started");
+    ESP_RETURN_ON_FALSE(!d->strip_bufs, ESP_ERR_INVALID_STATE, TAG,
+                        "strip mode");
+
+    BaseType_t core = tskNO_AFFINITY;
+#if portNUM_PROCESSORS > 1
+    core = !xPortGetCoreID(); // the core the caller is not on
+#endif
+    ssd1306_pipeline_cfg_t def = {.core_id = core};
+    if (!cfg)
+        cfg = &def;
+
+    struct ssd1306_pipe_t *p = calloc(1, sizeof(*p));
+    ESP_RETURN_ON_FALSE(p, ESP_ERR_NO_MEM, TAG, "no mem");
+    bool ok = true;
+    for (int i = 0; i < PIPE_SLOTS; ++i) {
+        p->buf[i] = ssd1306_buf_alloc(d, SSD1306_BUF_PIPE, d->fb_len);
+        p->box[i] = SSD1306_BOX_EMPTY;
+        ok        = ok && p->buf[i];
+    }
+    p->submit = xSemaphoreCreateMutex();
+    p->done   = xSemaphoreCreateBinary();
+    if (!ok || !p->submit || !p->done) {
+        pipe_free(d, p);
+        return ESP_ERR_NO_MEM;
+    }
+    p->back  = 0;
+    p->front = 2;
+    atomic_init(&p->ready, 1);
+
+    d->pipe = p;
+    if (xTaskCreatePinnedToCore(
+            flush_task, "ssd1306_flush",
+            cfg->stack_size ? cfg->stack_size : PIPE_DEFAULT_STACK, d,
+            cfg->priority ? cfg->priority : PIPE_DEFAULT_PRIO, &p->task,
+            cfg->core_id) != pdPASS) {
+        d->pipe = NULL;
+        pipe_free(d, p);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_pipeline_stop(ssd1306_handle_t h) {
+    struct ssd1306_t *d = h;
+    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
+    struct ssd1306_pipe_t *p = d->pipe;
+    if (!p)
+        return ESP_OK;
+
+    // No new submits; let the flush task finish its current frame.
+    xSemaphoreTake(p->submit, portMAX_DELAY);
+    p->stop = true;
+    xTaskNotifyGive(p->task);
+    xSemaphoreTake(p->done, portMAX_DELAY);
+
+    // A published frame that was never sent goes back to the dirty state.
+    unsigned cur = atomic_load(&p->ready);
+    if (cur & PIPE_SLOT_NEW) {
+        const ssd1306_box_t *b = &p->box[cur & PIPE_SLOT_MASK];
+        ssd1306_mark_dirty(d, b->x0, b->y0, b->x1, b->y1);
+    }
+
+    d->pipe = NULL;
+    xSemaphoreGive(p->submit);
+    pipe_free(d, p);
+    return ESP_OK;
+}
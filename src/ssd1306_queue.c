@@ -0,0 +1,245 @@
+// SPDX-License-Identifier: MIT
+/*
+ * ssd1306_queue.c - Multi-producer draw command queue and render task
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ */
+
+#include "ssd1306_private.h"
+
+#include <esp_check.h>
+#include <esp_log.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define QUEUE_DEFAULT_DEPTH 32
+#define QUEUE_DEFAULT_STACK 3072
+#define QUEUE_DEFAULT_PRIO  5
+
+static const char *TAG = "SSD1306_QUEUE";
+
+// One ring slot. seq implements a bounded MPSC ring (Vyukov style):
+//   seq == pos      slot is free for the producer claiming position pos
+//   seq == pos + 1  slot holds the command published at position pos
+typedef struct {
+    atomic_uint   seq;
+    ssd1306_cmd_t cmd;
+} queue_slot_t;
+
+struct ssd1306_queue_t {
+    queue_slot_t     *slots;
+    uint32_t          mask;
+    atomic_uint       head; // next position to claim (producers)
+    uint32_t          tail; // next position to consume (render task only)
+
+    TaskHandle_t      task;
+    SemaphoreHandle_t done; // given by the render task on exit
+    volatile bool     stop;
+    bool              auto_flush;
+};
+
+// Claim a slot and publish cmd. Never blocks; safe from ISRs.
+static bool queue_push(struct ssd1306_queue_t *q, const ssd1306_cmd_t *cmd) {
+    uint32_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    for (;;) {
+        queue_slot_t *s   = &q->slots[pos & q->mask];
+        uint32_t      seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+        int32_t       dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                s->cmd = *cmd;
+                atomic_store_explicit(&s->seq, pos + 1, memory_order_release);
+                return true;
+            }
+            // pos was reloaded by the failed CAS
+        } else if (dif < 0) {
+            return false; // full
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+}
+
+// Take the oldest published command. Render task only.
+static bool queue_pop(struct ssd1306_queue_t *q, ssd1306_cmd_t *out) {
+    queue_slot_t *s   = &q->slots[q->tail & q->mask];
+    uint32_t      seq = atomic_load_explicit(&s->seq, memory_order_acquire);
+    if ((int32_t)(seq - (q->tail + 1)) < 0)
+        return false; // empty (or producer still copying)
+    *out = s->cmd;
+    atomic_store_explicit(&s->seq, q->tail + q->mask + 1,
+                          memory_order_release);
+    q->tail++;
+    return true;
+}
+
+static void run_cmd(ssd1306_handle_t h, const ssd1306_cmd_t *c) {
+    esp_err_t err = ESP_OK;
+    switch (c->type) {
+    case SSD1306_CMD_CLEAR:
+        err = ssd1306_clear(h);
+        break;
+    case SSD1306_CMD_PIXEL:
+        err = ssd1306_draw_pixel(h, c->pixel.x, c->pixel.y, c->pixel.on);
+        break;
+    case SSD1306_CMD_RECT:
+        err = ssd1306_draw_rect(h, c->rect.x, c->rect.y, c->rect.w, c->rect.h,
+                                c->rect.fill);
+        break;
+    case SSD1306_CMD_LINE:
+        err = ssd1306_draw_line(h, c->line.x0, c->line.y0, c->line.x1,
+                                c->line.y1, c->line.on);
+        break;
+    case SSD1306_CMD_CIRCLE:
+        err = ssd1306_draw_circle(h, c->circle.x, c->circle.y, c->circle.r,
+                                  c->circle.fill);
+        break;
+    case SSD1306_CMD_TEXT: {
+        char txt[SSD1306_CMD_TEXT_MAX];
+        memcpy(txt, c->text.str, sizeof(txt));
+        txt[sizeof(txt) - 1] = '\0';
+        err = ssd1306_draw_text_scaled(h, c->text.x, c->text.y, txt,
+                                       c->text.on,
+                                       c->text.scale ? c->text.scale : 1);
+        break;
+    }
+    case SSD1306_CMD_FLUSH:
+        break; // handled by the drain loop
+    default:
+        err = ESP_ERR_INVALID_ARG;
+        break;
+    }
+    if (err != ESP_OK)
+        ESP_LOGD(TAG, "cmd %d: %s", c->type, esp_err_to_name(err));
+}
+
+static void render_task(void *arg) {
+    struct ssd1306_t       *d = arg;
+    struct ssd1306_queue_t *q = d->queue;
+    ssd1306_cmd_t           cmd;
+
+    while (!q->stop) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool drew = false, flush = false;
+        while (!q->stop && queue_pop(q, &cmd)) {
+            if (cmd.type == SSD1306_CMD_FLUSH) {
+                flush = true;
+                continue;
+            }
+            run_cmd(d, &cmd);
+            drew = true;
+        }
+        if (!q->stop && (flush || (drew && q->auto_flush)))
+            (void)ssd1306_display(d);
+    }
+
+    xSemaphoreGive(q->done);
+    vTaskDelete(NULL);
+}
+
+static void queue_free(struct ssd1306_t *d, struct ssd1306_queue_t *q) {
+    if (q->done)
+        vSemaphoreDelete(q->done);
+    ssd1306_buf_free(d, SSD1306_BUF_QUEUE, q->slots);
+    free(q);
+}
+
+esp_err_t ssd1306_queue_start(ssd1306_handle_t h,
+                              const ssd1306_queue_cfg_t *cfg) {
+    struct ssd1306_t *d = h;
+    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
+    ESP_RETURN_ON_FALSE(!d->queue, ESP_ERR_INVALID_STATE, TAG,
+                        "already started");
+
+    const ssd1306_queue_cfg_t def = {0};
+    if (!cfg)
+        cfg = &def;
+
+    uint32_t depth = cfg->depth ? cfg->depth : QUEUE_DEFAULT_DEPTH;
+    ESP_RETURN_ON_FALSE((depth & (depth - 1)) == 0, ESP_ERR_INVALID_ARG, TAG,
+                        "depth must be a power of two");
+
+    struct ssd1306_queue_t *q = calloc(1, sizeof(*q));
+    ESP_RETURN_ON_FALSE(q, ESP_ERR_NO_MEM, TAG, "no mem");
+    q->slots =
+        ssd1306_buf_alloc(d, SSD1306_BUF_QUEUE, depth * sizeof(*q->slots));
+    q->done  = xSemaphoreCreateBinary();
+    if (!q->slots || !q->done) {
+        queue_free(d, q);
+        return ESP_ERR_NO_MEM;
+    }
+    q->mask       = depth - 1;
+    q->auto_flush = cfg->auto_flush;
+    for (uint32_t i = 0; i < depth; ++i)
+        atomic_init(&q->slots[i].seq, i);
+    atomic_init(&q->head, 0);
+
+    d->queue = q;
+    if (xTaskCreate(render_task, "ssd1306_render",
+                    cfg->stack_size ? cfg->stack_size : QUEUE_DEFAULT_STACK, d,
+                    cfg->priority ? cfg->priority : QUEUE_DEFAULT_PRIO,
+                    &q->task) != pdPASS) {
+        d->queue = NULL;
+        queue_free(d, q);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_queue_stop(ssd1306_handle_t h) {
+    struct ssd1306_t *d = h;
+    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
+    struct ssd1306_queue_t *q = d->queue;
+    if (!q)
+        return ESP_OK;
+
+    q->stop = true;
+    xTaskNotifyGive(q->task);
+    xSemaphoreTake(q->done, portMAX_DELAY);
+
+    d->queue = NULL;
+    queue_free(d, q);
+    return ESP_OK;
+}
+
+static void count_drop(struct ssd1306_t *d) {
+    portENTER_CRITICAL_SAFE(&d->spin);
+    d->stats.queue_drops++;
+    portEXIT_CRITICAL_SAFE(&d->spin);
+}
+
+esp_err_t ssd1306_post(ssd1306_handle_t h, const ssd1306_cmd_t *cmd) {
+    struct ssd1306_t *d = h;
+    if (!d || !cmd)
+        return ESP_ERR_INVALID_ARG;
+    struct ssd1306_queue_t *q = d->queue;
+    if (!q)
+        return ESP_ERR_INVALID_STATE;
+
+    if (!queue_push(q, cmd)) {
+        count_drop(d);
+        return ESP_ERR_NO_MEM;
+    }
+    xTaskNotifyGive(q->task);
+    return ESP_OK;
+}
+
+esp_err_t ssd1306_post_from_isr(ssd1306_handle_t h, const ssd1306_cmd_t *cmd,
+                                BaseType_t *woken) {
+    struct ssd1306_t *d = h;
+    if (!d || !cmd)
+        return ESP_ERR_INVALID_ARG;
+    struct ssd1306_queue_t *q = d->queue;
+    if (!q)
+        return ESP_ERR_INVALID_STATE;
+
+    if (!queue_push(q, cmd)) {
+        count_drop(d);
+        return ESP_ERR_NO_MEM;
+    }
+    vTaskNotifyGiveFromISR(q->task, woken);
+    return ESP_OK;
+}
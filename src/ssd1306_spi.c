@@ -10,29 +10,63 @@
 #include <driver/spi_master.h>
 #include <esp_check.h>
 #include <esp_log.h>
+#include <soc/soc_caps.h>
 #include <string.h>
 
+#if SOC_DEDICATED_GPIO_SUPPORTED
+#include <driver/dedic_gpio.h>
+#endif
+
 #define TAG "SSD1306_SPI"
 
+#define SPI_RING     4    // queued transactions per device (queue_size)
+#define SPI_CMD_MAX  32   // command bytes per transaction
+#define SPI_DATA_MAX 1024 // data bytes per transaction
+
 // ---- Backend context ----
 typedef struct {
-    spi_device_handle_t dev;
-    spi_host_device_t   host;
-    gpio_num_t          dc_gpio;  // required for 4-wire SPI
-    gpio_num_t          rst_gpio; // optional, GPIO_NUM_NC if not used
-    int                 clk_hz;   // configured clock
+    spi_device_handle_t       dev;
+    spi_host_device_t         host;
+    gpio_num_t                dc_gpio;  // required for 4-wire SPI
+    gpio_num_t                rst_gpio; // optional, GPIO_NUM_NC if not used
+    int                       clk_hz;   // configured clock
+    TickType_t                timeout;  // per transaction
+    const ssd1306_fairness_t *fair;     // the display's; no bus hold if set
+    ssd1306_spi_dc_mode_t     dc_mode;
+    int8_t                    dc_level; // last level driven, -1 unknown
+    bool                      held;     // bus acquired for a flush
+    bool                      batch;    // in a flush: data may stay queued
+
+    // Reusable transactions, zeroed at bind; entries are queued round robin
+    // and reaped in order.
+    spi_transaction_t ring[SPI_RING];
+    uint8_t           head;     // next entry to queue
+    uint8_t           inflight; // queued, not yet reaped
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    dedic_gpio_bundle_handle_t dc_bundle; // DEDICATED mode, NULL until used
+    portMUX_TYPE               dc_spin;   // pins the task to check dc_core
+    int8_t                     dc_core;   // core owning dc_bundle
+#endif
 } ssd1306_spi_ctx_t;
 
+SSD1306_STATIC_CTX_CHECK(ssd1306_spi_ctx_t);
+
 // ---- Forward declarations for vtable ----
 static esp_err_t spi_send_cmd(void *ctx, const uint8_t *cmd, size_t n);
 static esp_err_t spi_send_data(void *ctx, const uint8_t *data, size_t n);
 static esp_err_t spi_reset(void *ctx);
+static esp_err_t spi_begin(void *ctx);
+static esp_err_t spi_end(void *ctx);
+static esp_err_t spi_wait_idle(void *ctx, TickType_t timeout);
 
 // Vtable
 static const ssd1306_bus_vt_t VT_SPI = {
     .send_cmd  = spi_send_cmd,
     .send_data = spi_send_data,
     .reset     = spi_reset,
+    .begin     = spi_begin,
+    .end       = spi_end,
+    .wait_idle = spi_wait_idle,
 };
 
 // ---- DC handling via pre-transfer callback ----
@@ -64,8 +98,10 @@ static inline void gpio_conf_output(gpio_num_t pin, int level) {
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
         .intr_type    = GPIO_INTR_DISABLE,
     };
-    (void)gpio_config(&io);
+    // Latch the level first so the pin never glitches (a low blip on RES#
+    // would undo a warm attach).
     (void)gpio_set_level(pin, level);
+    (void)gpio_config(&io);
 }
 
 static inline void gpio_conf_disable(gpio_num_t pin) {
@@ -81,13 +117,78 @@ static inline void gpio_conf_disable(gpio_num_t pin) {
     (void)gpio_config(&io);
 }
 
-esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, spi_host_device_t host,
-                           gpio_num_t cs_gpio, gpio_num_t dc_gpio,
-                           gpio_num_t rst_gpio, int clk_hz) {
-    ESP_RETURN_ON_FALSE(d, ESP_ERR_INVALID_ARG, TAG, "null dev");
-    ESP_RETURN_ON_FALSE(dc_gpio != GPIO_NUM_NC, ESP_ERR_INVALID_ARG, TAG,
+// ---- DC handling from the task ----
+// ring_queue() drains the ring before D/C changes, so the previous transfer
+// is finished and D/C can be switched right away; it is only touched when
+// the level changes.
+#if SOC_DEDICATED_GPIO_SUPPORTED
+// Give up on the bundle: release it and drive D/C through the GPIO matrix.
+static void dc_dedicated_off(ssd1306_spi_ctx_t *c, const char *why) {
+    ESP_LOGW(TAG, "%s, using gpio_set_level for D/C", why);
+    if (c->dc_bundle)
+        (void)dedic_gpio_del_bundle(c->dc_bundle);
+    c->dc_bundle = NULL;
+    c->dc_mode   = SSD1306_SPI_DC_DIRECT;
+    gpio_conf_output(c->dc_gpio, c->dc_level > 0);
+}
+
+// A dedicated-GPIO bundle only drives its pins from the core that created
+// it, so it is opened by the first send (on the core that flushes, e.g. the
+// pipeline's flush task) rather than at bind. Returns false once sends come
+// from another core and D/C has fallen back to DIRECT.
+static bool dc_dedicated_write(ssd1306_spi_ctx_t *c, int level) {
+    if (!c->dc_bundle) {
+        const int                        pin  = c->dc_gpio;
+        const dedic_gpio_bundle_config_t bcfg = {
+            .gpio_array = &pin,
+            .array_size = 1,
+            .flags      = {.out_en = 1},
+        };
+        const BaseType_t core = xPortGetCoreID();
+        if (dedic_gpio_new_bundle(&bcfg, &c->dc_bundle) != ESP_OK) {
+            c->dc_bundle = NULL;
+            dc_dedicated_off(c, "no dedicated GPIO");
+            return false;
+        }
+        if (xPortGetCoreID() != core) { // migrated while opening it
+            dc_dedicated_off(c, "D/C bundle core unknown");
+            return false;
+        }
+        c->dc_core = (int8_t)core;
+    }
+    // No migration between the core check and the write.
+    portENTER_CRITICAL(&c->dc_spin);
+    const bool same = xPortGetCoreID() == c->dc_core;
+    if (same)
+        dedic_gpio_bundle_write(c->dc_bundle, 1, (uint32_t)level);
+    portEXIT_CRITICAL(&c->dc_spin);
+    if (!same)
+        dc_dedicated_off(c, "D/C sent from another core");
+    return same;
+}
+#endif
+
+static inline void set_dc(ssd1306_spi_ctx_t *c, int level) {
+    if (c->dc_mode == SSD1306_SPI_DC_CALLBACK || c->dc_level == level)
+        return;
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (c->dc_mode != SSD1306_SPI_DC_DEDICATED ||
+        !dc_dedicated_write(c, level))
+#endif
+        gpio_set_level(c->dc_gpio, level);
+    c->dc_level = (int8_t)level;
+}
+
+esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, const ssd1306_spi_cfg_t *cfg) {
+    ESP_RETURN_ON_FALSE(d && cfg, ESP_ERR_INVALID_ARG, TAG, "null arg");
+    ESP_RETURN_ON_FALSE(cfg->dc_gpio != GPIO_NUM_NC, ESP_ERR_INVALID_ARG, TAG,
                         "D/C pin required");
 
+    const spi_host_device_t host     = cfg->host;
+    const gpio_num_t        dc_gpio  = cfg->dc_gpio;
+    const gpio_num_t        rst_gpio = cfg->rst_gpio;
+    int                     clk_hz   = cfg->clk_hz;
+
     if (clk_hz <= 0)
         clk_hz = 8 * 1000 * 1000; // safe default 8 MHz
 
@@ -99,9 +200,11 @@ esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, spi_host_device_t host,
     spi_device_interface_config_t devcfg = {
         .clock_speed_hz = clk_hz,
         .mode           = 0, // SSD1306 = SPI mode 0
-        .spics_io_num   = cs_gpio,
-        .queue_size     = 2,
-        .pre_cb         = spi_pre_cb_set_dc,
+        .spics_io_num   = cfg->cs_gpio,
+        .queue_size     = SPI_RING,
+        .pre_cb         = cfg->dc_mode == SSD1306_SPI_DC_CALLBACK
+                              ? spi_pre_cb_set_dc
+                              : NULL,
         .flags          = 0,
     };
 
@@ -110,7 +213,8 @@ esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, spi_host_device_t host,
                         "spi_bus_add_device");
 
     // Allocate context
-    ssd1306_spi_ctx_t *ctx = (ssd1306_spi_ctx_t *)calloc(1, sizeof(*ctx));
+    ssd1306_spi_ctx_t *ctx =
+        (ssd1306_spi_ctx_t *)ssd1306_ctx_alloc(d, sizeof(*ctx));
     if (!ctx) {
         (void)spi_bus_remove_device(dev);
         return ESP_ERR_NO_MEM;
@@ -120,46 +224,90 @@ esp_err_t ssd1306_bind_spi(struct ssd1306_t *d, spi_host_device_t host,
     ctx->dc_gpio  = dc_gpio;
     ctx->rst_gpio = rst_gpio;
     ctx->clk_hz   = clk_hz;
-
-    // Optional hardware reset pulse
-    if (rst_gpio != GPIO_NUM_NC) {
-        gpio_set_level(rst_gpio, 1);
-        vTaskDelay(pdMS_TO_TICKS(1));
-        gpio_set_level(rst_gpio, 0);
-        vTaskDelay(pdMS_TO_TICKS(1));
-        gpio_set_level(rst_gpio, 1);
-        vTaskDelay(pdMS_TO_TICKS(5));
+    ctx->timeout  = pdMS_TO_TICKS(d->xfer_timeout_ms);
+    ctx->fair     = &d->fair;
+    ctx->dc_mode  = cfg->dc_mode;
+    ctx->dc_level = 0; // configured low above
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    // The bundle is opened by the first send, see dc_dedicated_write().
+    ctx->dc_core = -1;
+    portMUX_INITIALIZE(&ctx->dc_spin);
+#else
+    if (cfg->dc_mode == SSD1306_SPI_DC_DEDICATED) {
+        ESP_LOGW(TAG, "no dedicated GPIO on this chip, using gpio_set_level");
+        ctx->dc_mode = SSD1306_SPI_DC_DIRECT;
     }
+#endif
 
     d->vt      = &VT_SPI;
     d->bus_ctx = ctx;
+    d->bus     = SSD1306_SPI;
+    d->bus_key = SSD1306_BUS_KEY(SSD1306_SPI, host);
+    // Defaults unless configured: polling transaction setup and the D/C
+    // callback dominate short sends.
+    if (!d->cost.byte_ns) {
+        d->cost.setup_ns = 20000;
+        d->cost.byte_ns  = (uint32_t)(8000000000ULL / (uint64_t)clk_hz);
+        d->cost.cmd_ns   = d->cost.setup_ns + 6 * d->cost.byte_ns;
+    }
 
     return ESP_OK;
 }
 
+// ---- Transaction ring ----
+// Reap finished transactions until at most keep are in flight.
+static esp_err_t ring_reap(ssd1306_spi_ctx_t *ctx, unsigned keep,
+                           TickType_t timeout) {
+    while (ctx->inflight > keep) {
+        spi_transaction_t *done = NULL;
+        ESP_RETURN_ON_ERROR(
+            spi_device_get_trans_result(ctx->dev, &done, timeout), TAG,
+            "xfer timeout");
+        ctx->inflight--;
+    }
+    return ESP_OK;
+}
+
+// Queue n bytes with D/C = dc in transactions of at most max bytes, filling
+// in only length, buffer and D/C of the next ring entry. Returns with the
+// transactions in flight.
+static esp_err_t ring_queue(ssd1306_spi_ctx_t *ctx, int dc, const uint8_t *buf,
+                            size_t n, size_t max) {
+    // D/C driven from the task may only change once the bus is quiet.
+    if (ctx->dc_mode != SSD1306_SPI_DC_CALLBACK && ctx->dc_level != dc)
+        ESP_RETURN_ON_ERROR(ring_reap(ctx, 0, ctx->timeout), TAG, "drain");
+    set_dc(ctx, dc);
+
+    size_t off = 0;
+    while (off < n) {
+        const size_t blk = (n - off) > max ? max : (n - off);
+        ESP_RETURN_ON_ERROR(ring_reap(ctx, SPI_RING - 1, ctx->timeout), TAG,
+                            "ring full");
+
+        spi_transaction_t *t = &ctx->ring[ctx->head];
+        t->length            = (uint32_t)(blk * 8);
+        t->tx_buffer         = &buf[off];
+        t->user              = pack_user(ctx, dc);
+        ESP_RETURN_ON_ERROR(spi_device_queue_trans(ctx->dev, t, ctx->timeout),
+                            TAG, "queue xfer");
+        ctx->head = (uint8_t)((ctx->head + 1) % SPI_RING);
+        ctx->inflight++;
+        off += blk;
+    }
+    return ESP_OK;
+}
+
 // ---- Vtable methods ----
 static esp_err_t spi_send_cmd(void *ctx_, const uint8_t *cmds, size_t n) {
     ssd1306_spi_ctx_t *ctx = (ssd1306_spi_ctx_t *)ctx_;
     if (!ctx || !cmds || n == 0)
         return ESP_OK;
 
-    // Commands are tiny; still chunk conservatively.
-    const size_t MAX = 32;
-    size_t       off = 0;
-    while (off < n) {
-        size_t            blk = (n - off) > MAX ? MAX : (n - off);
-
-        spi_transaction_t t;
-        memset(&t, 0, sizeof(t));
-        t.length    = (uint32_t)(blk * 8);
-        t.tx_buffer = &cmds[off];
-        t.user      = pack_user(ctx, 0); // D/C = 0 (command)
-
-        ESP_RETURN_ON_ERROR(spi_device_polling_transmit(ctx->dev, &t), TAG,
-                            "cmd xfer");
-        off += blk;
-    }
-    return ESP_OK;
+    // Commands usually live on the caller's stack: wait for them.
+    ESP_RETURN_ON_ERROR(ring_queue(ctx, 0, cmds, n, SPI_CMD_MAX), TAG,
+                        "cmd xfer");
+    return ring_reap(ctx, 0, ctx->timeout);
 }
 
 static esp_err_t spi_send_data(void *ctx_, const uint8_t *data, size_t n) {
@@ -167,23 +315,41 @@ static esp_err_t spi_send_data(void *ctx_, const uint8_t *data, size_t n) {
     if (!ctx || !data || n == 0)
         return ESP_OK;
 
-    // Framebuffer is ~1KB; 1024-byte chunks are fine.
-    const size_t MAX = 1024;
-    size_t       off = 0;
-    while (off < n) {
-        size_t            blk = (n - off) > MAX ? MAX : (n - off);
+    ESP_RETURN_ON_ERROR(ring_queue(ctx, 1, data, n, SPI_DATA_MAX), TAG,
+                        "data xfer");
+    // Within a flush the buffer stays put until spi_end() reaps everything.
+    return ctx->batch ? ESP_OK : ring_reap(ctx, 0, ctx->timeout);
+}
 
-        spi_transaction_t t;
-        memset(&t, 0, sizeof(t));
-        t.length    = (uint32_t)(blk * 8);
-        t.tx_buffer = &data[off];
-        t.user      = pack_user(ctx, 1); // D/C = 1 (data)
+// Unless fairness asks to let other devices in between, keep the bus for
+// the whole flush (no per-transaction bus acquisition) and leave its data
+// queued until the end. The driver only accepts portMAX_DELAY here, so the
+// configured timeout bounds the transactions, not the wait for the bus.
+static esp_err_t spi_begin(void *ctx_) {
+    ssd1306_spi_ctx_t        *ctx = ctx_;
+    const ssd1306_fairness_t *f   = ctx->fair;
+    if (f->max_xfer_bytes || f->gap_us || f->yield_cb)
+        return ESP_OK;
+    ESP_RETURN_ON_ERROR(spi_device_acquire_bus(ctx->dev, portMAX_DELAY), TAG,
+                        "acquire bus");
+    ctx->held  = true;
+    ctx->batch = true;
+    return ESP_OK;
+}
 
-        ESP_RETURN_ON_ERROR(spi_device_polling_transmit(ctx->dev, &t), TAG,
-                            "data xfer");
-        off += blk;
+static esp_err_t spi_end(void *ctx_) {
+    ssd1306_spi_ctx_t *ctx = ctx_;
+    esp_err_t          err = ring_reap(ctx, 0, ctx->timeout);
+    if (ctx->held) {
+        spi_device_release_bus(ctx->dev);
+        ctx->held = false;
     }
-    return ESP_OK;
+    ctx->batch = false;
+    return err;
+}
+
+static esp_err_t spi_wait_idle(void *ctx, TickType_t timeout) {
+    return ring_reap(ctx, 0, timeout);
 }
 
 static esp_err_t spi_reset(void *ctx_) {
@@ -194,11 +360,7 @@ static esp_err_t spi_reset(void *ctx_) {
     if (ctx->rst_gpio == GPIO_NUM_NC)
         return ESP_OK;
 
-    gpio_set_level(ctx->rst_gpio, 0);
-    vTaskDelay(pdMS_TO_TICKS(10));
-    gpio_set_level(ctx->rst_gpio, 1);
-    vTaskDelay(pdMS_TO_TICKS(10));
-
+    ssd1306_reset_pulse(ctx->rst_gpio);
     return ESP_OK;
 }
 
@@ -210,6 +372,7 @@ esp_err_t ssd1306_unbind_spi(struct ssd1306_t *d) {
     esp_err_t          ret = ESP_OK;
 
     if (ctx->dev) {
+        (void)ring_reap(ctx, 0, ctx->timeout);
         esp_err_t e = spi_bus_remove_device(ctx->dev);
         if (e != ESP_OK) {
             ESP_LOGW(TAG, "spi_bus_remove_device failed: %s",
@@ -219,11 +382,16 @@ esp_err_t ssd1306_unbind_spi(struct ssd1306_t *d) {
         ctx->dev = NULL;
     }
 
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (ctx->dc_bundle)
+        (void)dedic_gpio_del_bundle(ctx->dc_bundle);
+#endif
+
     // Neutralize pins
     gpio_conf_disable(ctx->dc_gpio);
     gpio_conf_disable(ctx->rst_gpio);
 
-    free(ctx);
+    ssd1306_ctx_free(d, ctx);
     d->bus_ctx = NULL;
     d->vt      = NULL;
 
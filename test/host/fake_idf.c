@@ -0,0 +1,648 @@
+// SPDX-License-Identifier: MIT
+/*
+ * fake_idf.c - Host stand-ins for the IDF and FreeRTOS calls the driver uses
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ *
+ * Tasks are detached pthreads, semaphores and queues are built on a mutex and
+ * a condition variable, and every spinlock maps to one recursive lock. I2C
+ * and SPI devices accept every write; I2C writes are logged for the tests and
+ * complete (for async devices) before i2c_master_transmit() returns.
+ * Device objects come from static pools, so the fakes allocate no memory the
+ * driver did not ask for itself.
+ */
+
+#include "fake_idf.h"
+
+#include <driver/dedic_gpio.h>
+#include <driver/gpio.h>
+#include <driver/i2c_master.h>
+#include <driver/spi_master.h>
+#include <esp_heap_caps.h>
+#include <esp_memory_utils.h>
+#include <esp_rom_crc.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FAKE_MAX_TASKS   16
+#define FAKE_MAX_I2C_DEV 16
+#define FAKE_MAX_SPI_DEV 8
+#define FAKE_SPI_QUEUE   8
+
+// ---- Time ----
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void esp_rom_delay_us(uint32_t us) { (void)us; }
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    usleep((useconds_t)ticks * portTICK_PERIOD_MS * 1000);
+}
+
+void taskYIELD(void) { sched_yield(); }
+
+BaseType_t xPortGetCoreID(void) { return 0; }
+
+// Absolute deadline for a wait of ticks; false for portMAX_DELAY.
+static bool deadline(TickType_t ticks, struct timespec *ts) {
+    if (ticks == portMAX_DELAY)
+        return false;
+    clock_gettime(CLOCK_REALTIME, ts);
+    const int64_t ns = ts->tv_nsec + (int64_t)ticks * portTICK_PERIOD_MS *
+                                         1000000;
+    ts->tv_sec += ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
+    return true;
+}
+
+// Wait on cv; false once the deadline has passed.
+static bool wait(pthread_cond_t *cv, pthread_mutex_t *mx, bool timed,
+                 const struct timespec *ts) {
+    if (!timed)
+        return pthread_cond_wait(cv, mx) == 0;
+    return pthread_cond_timedwait(cv, mx, ts) != ETIMEDOUT;
+}
+
+// ---- Misc ----
+const char *esp_err_to_name(esp_err_t err) {
+    switch (err) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    default:
+        return "ESP_FAIL";
+    }
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; ++k)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+bool esp_ptr_internal(const void *p) { return p != NULL; }
+bool esp_ptr_dma_capable(const void *p) { return p != NULL; }
+bool esp_ptr_external_ram(const void *p) { return false; }
+
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+    return calloc(n, size);
+}
+void *heap_caps_malloc(size_t size, uint32_t caps) { return malloc(size); }
+void  heap_caps_free(void *p) { free(p); }
+
+esp_err_t gpio_config(const gpio_config_t *cfg) { return ESP_OK; }
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) { return ESP_OK; }
+
+static int dedic_dummy;
+esp_err_t  dedic_gpio_new_bundle(const dedic_gpio_bundle_config_t *cfg,
+                                 dedic_gpio_bundle_handle_t       *out) {
+    *out = (dedic_gpio_bundle_handle_t)&dedic_dummy;
+    return ESP_OK;
+}
+esp_err_t dedic_gpio_del_bundle(dedic_gpio_bundle_handle_t b) { return ESP_OK; }
+void      dedic_gpio_bundle_write(dedic_gpio_bundle_handle_t b, uint32_t mask,
+                                  uint32_t value) {}
+
+// ---- Critical sections ----
+static pthread_mutex_t critical_mx;
+static pthread_once_t  critical_once = PTHREAD_ONCE_INIT;
+
+static void critical_init(void) {
+    pthread_mutexattr_t a;
+    pthread_mutexattr_init(&a);
+    pthread_mutexattr_settype(&a, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&critical_mx, &a);
+    pthread_mutexattr_destroy(&a);
+}
+
+void fake_critical_enter(portMUX_TYPE *m) {
+    pthread_once(&critical_once, critical_init);
+    pthread_mutex_lock(&critical_mx);
+}
+
+void fake_critical_exit(portMUX_TYPE *m) { pthread_mutex_unlock(&critical_mx); }
+
+// ---- Tasks ----
+typedef struct {
+    bool           used;
+    bool           waiting; // blocked in ulTaskNotifyTake()
+    uint32_t       notify;
+    TaskFunction_t fn;
+    void          *arg;
+} fake_task_t;
+
+static pthread_mutex_t      task_mx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t       task_cv = PTHREAD_COND_INITIALIZER;
+static fake_task_t          tasks[FAKE_MAX_TASKS];
+static fake_task_t          main_task = {.used = true};
+static bool                 tasks_held;
+static __thread fake_task_t *self;
+
+static void *task_main(void *arg) {
+    fake_task_t *t = arg;
+    self           = t;
+    t->fn(t->arg);
+    vTaskDelete(NULL);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack,
+                       void *arg, UBaseType_t prio, TaskHandle_t *out) {
+    fake_task_t *t = NULL;
+    pthread_mutex_lock(&task_mx);
+    for (int i = 0; i < FAKE_MAX_TASKS && !t; ++i) {
+        if (!tasks[i].used)
+            t = &tasks[i];
+    }
+    if (t)
+        *t = (fake_task_t){.used = true, .fn = fn, .arg = arg};
+    pthread_mutex_unlock(&task_mx);
+    if (!t)
+        return pdFALSE;
+
+    pthread_t      th;
+    pthread_attr_t a;
+    pthread_attr_init(&a);
+    pthread_attr_setdetachstate(&a, PTHREAD_CREATE_DETACHED);
+    const int err = pthread_create(&th, &a, task_main, t);
+    pthread_attr_destroy(&a);
+    if (err) {
+        t->used = false;
+        return pdFALSE;
+    }
+    if (out)
+        *out = t;
+    return pdPASS;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack, void *arg, UBaseType_t prio,
+                                   TaskHandle_t *out, BaseType_t core) {
+    return xTaskCreate(fn, name, stack, arg, prio, out);
+}
+
+// Only a task deleting itself is supported, as in the driver.
+void vTaskDelete(TaskHandle_t t) {
+    pthread_mutex_lock(&task_mx);
+    self->used = false;
+    pthread_cond_broadcast(&task_cv);
+    pthread_mutex_unlock(&task_mx);
+    pthread_exit(NULL);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return self ? self : &main_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t h) {
+    fake_task_t *t = h;
+    pthread_mutex_lock(&task_mx);
+    t->notify++;
+    pthread_cond_broadcast(&task_cv);
+    pthread_mutex_unlock(&task_mx);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t h, BaseType_t *woken) {
+    xTaskNotifyGive(h);
+    if (woken)
+        *woken = pdTRUE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    fake_task_t    *t = xTaskGetCurrentTaskHandle();
+    struct timespec ts;
+    const bool      timed = deadline(ticks, &ts);
+
+    pthread_mutex_lock(&task_mx);
+    t->waiting = true;
+    pthread_cond_broadcast(&task_cv);
+    while (!t->notify || (tasks_held && t != &main_task)) {
+        if (!wait(&task_cv, &task_mx, timed, &ts))
+            break;
+    }
+    t->waiting = false;
+    uint32_t n = 0;
+    if (t->notify && !(tasks_held && t != &main_task)) {
+        n         = t->notify;
+        t->notify = clear ? 0 : n - 1;
+    }
+    pthread_mutex_unlock(&task_mx);
+    return n;
+}
+
+void fake_tasks_hold(bool hold) {
+    pthread_mutex_lock(&task_mx);
+    tasks_held = hold;
+    pthread_cond_broadcast(&task_cv);
+    pthread_mutex_unlock(&task_mx);
+}
+
+bool fake_tasks_idle(void) {
+    bool idle = true;
+    pthread_mutex_lock(&task_mx);
+    for (int i = 0; i < FAKE_MAX_TASKS; ++i) {
+        if (tasks[i].used && !tasks[i].waiting)
+            idle = false;
+    }
+    pthread_mutex_unlock(&task_mx);
+    return idle;
+}
+
+// ---- Semaphores ----
+typedef struct {
+    pthread_mutex_t mx;
+    pthread_cond_t  cv;
+    unsigned        count, max;
+    bool            recursive;
+    bool            is_static;
+    void           *owner; // recursive mutexes
+    unsigned        depth;
+} fake_sem_t;
+
+_Static_assert(sizeof(fake_sem_t) <= sizeof(StaticSemaphore_t),
+               "StaticSemaphore_t too small for the fake");
+
+static SemaphoreHandle_t sem_init(fake_sem_t *s, unsigned max, unsigned count,
+                                  bool recursive, bool is_static) {
+    if (!s)
+        return NULL;
+    pthread_mutex_init(&s->mx, NULL);
+    pthread_cond_init(&s->cv, NULL);
+    s->count     = count;
+    s->max       = max;
+    s->recursive = recursive;
+    s->is_static = is_static;
+    s->owner     = NULL;
+    s->depth     = 0;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return sem_init(malloc(sizeof(fake_sem_t)), 1, 1, false, false);
+}
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return sem_init(malloc(sizeof(fake_sem_t)), 1, 0, false, false);
+}
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t n) {
+    return sem_init(malloc(sizeof(fake_sem_t)), max, n, false, false);
+}
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    return sem_init(malloc(sizeof(fake_sem_t)), 1, 1, true, false);
+}
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf) {
+    return sem_init((fake_sem_t *)buf, 1, 1, false, true);
+}
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf) {
+    return sem_init((fake_sem_t *)buf, 1, 0, false, true);
+}
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t max, UBaseType_t n,
+                                                 StaticSemaphore_t *buf) {
+    return sem_init((fake_sem_t *)buf, max, n, false, true);
+}
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *buf) {
+    return sem_init((fake_sem_t *)buf, 1, 1, true, true);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t h, TickType_t ticks) {
+    fake_sem_t     *s = h;
+    struct timespec ts;
+    const bool      timed = deadline(ticks, &ts);
+    void           *me    = xTaskGetCurrentTaskHandle();
+
+    pthread_mutex_lock(&s->mx);
+    if (s->recursive && s->depth && s->owner == me) {
+        s->depth++;
+        pthread_mutex_unlock(&s->mx);
+        return pdTRUE;
+    }
+    bool ok = true;
+    while (!s->count && ok) {
+        ok = ticks && wait(&s->cv, &s->mx, timed, &ts);
+    }
+    ok = s->count > 0;
+    if (ok) {
+        s->count--;
+        s->owner = me;
+        s->depth = 1;
+    }
+    pthread_mutex_unlock(&s->mx);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t h) {
+    fake_sem_t *s = h;
+    BaseType_t  ok;
+    pthread_mutex_lock(&s->mx);
+    if (s->recursive && --s->depth) {
+        pthread_mutex_unlock(&s->mx);
+        return pdTRUE;
+    }
+    ok = s->count < s->max;
+    if (ok) {
+        s->count++;
+        s->owner = NULL;
+        pthread_cond_broadcast(&s->cv);
+    }
+    pthread_mutex_unlock(&s->mx);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t h, BaseType_t *woken) {
+    return xSemaphoreGive(h);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t h, TickType_t ticks) {
+    return xSemaphoreTake(h, ticks);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t h) {
+    return xSemaphoreGive(h);
+}
+
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t h) {
+    fake_sem_t *s = h;
+    pthread_mutex_lock(&s->mx);
+    const unsigned n = s->count;
+    pthread_mutex_unlock(&s->mx);
+    return n;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t h) {
+    fake_sem_t *s = h;
+    pthread_cond_destroy(&s->cv);
+    pthread_mutex_destroy(&s->mx);
+    if (!s->is_static)
+        free(s);
+}
+
+// ---- Queues ----
+typedef struct {
+    pthread_mutex_t mx;
+    pthread_cond_t  cv;
+    size_t          size;
+    unsigned        len, head, count;
+    uint8_t         buf[];
+} fake_queue_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t size) {
+    fake_queue_t *q = malloc(sizeof(*q) + (size_t)len * size);
+    if (!q)
+        return NULL;
+    pthread_mutex_init(&q->mx, NULL);
+    pthread_cond_init(&q->cv, NULL);
+    q->size  = size;
+    q->len   = len;
+    q->head  = 0;
+    q->count = 0;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t h, const void *item, TickType_t ticks) {
+    fake_queue_t   *q = h;
+    struct timespec ts;
+    const bool      timed = deadline(ticks, &ts);
+    bool            ok    = true;
+
+    pthread_mutex_lock(&q->mx);
+    while (q->count == q->len && ok)
+        ok = ticks && wait(&q->cv, &q->mx, timed, &ts);
+    ok = q->count < q->len;
+    if (ok) {
+        memcpy(&q->buf[(size_t)((q->head + q->count) % q->len) * q->size],
+               item, q->size);
+        q->count++;
+        pthread_cond_broadcast(&q->cv);
+    }
+    pthread_mutex_unlock(&q->mx);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t h, void *item, TickType_t ticks) {
+    fake_queue_t   *q = h;
+    struct timespec ts;
+    const bool      timed = deadline(ticks, &ts);
+    bool            ok    = true;
+
+    pthread_mutex_lock(&q->mx);
+    while (!q->count && ok)
+        ok = ticks && wait(&q->cv, &q->mx, timed, &ts);
+    ok = q->count > 0;
+    if (ok) {
+        memcpy(item, &q->buf[(size_t)q->head * q->size], q->size);
+        q->head = (q->head + 1) % q->len;
+        q->count--;
+        pthread_cond_broadcast(&q->cv);
+    }
+    pthread_mutex_unlock(&q->mx);
+    return ok ? pdTRUE : pdFALSE;
+}
+
+void vQueueDelete(QueueHandle_t h) {
+    fake_queue_t *q = h;
+    pthread_cond_destroy(&q->cv);
+    pthread_mutex_destroy(&q->mx);
+    free(q);
+}
+
+// ---- I2C ----
+struct i2c_master_bus_t {
+    int port;
+};
+
+struct i2c_master_dev_t {
+    bool                  used;
+    uint16_t              addr;
+    i2c_master_callback_t on_done; // async devices: called as each write ends
+    void                 *arg;
+};
+
+static struct i2c_master_bus_t i2c_buses[2] = {{0}, {1}};
+static struct i2c_master_dev_t i2c_devs[FAKE_MAX_I2C_DEV];
+static pthread_mutex_t         i2c_mx = PTHREAD_MUTEX_INITIALIZER;
+static fake_i2c_xfer_t         i2c_log[FAKE_I2C_LOG_MAX];
+static size_t                  i2c_log_len;
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *cfg,
+                             i2c_master_bus_handle_t       *out) {
+    return i2c_master_get_bus_handle(cfg->i2c_port, out);
+}
+
+esp_err_t i2c_master_get_bus_handle(i2c_port_num_t                port,
+                                    i2c_master_bus_handle_t *out) {
+    if (port < 0 || port > 1)
+        return ESP_ERR_INVALID_ARG;
+    *out = &i2c_buses[port];
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t    bus,
+                                    const i2c_device_config_t *cfg,
+                                    i2c_master_dev_handle_t   *out) {
+    esp_err_t err = ESP_ERR_NO_MEM;
+    pthread_mutex_lock(&i2c_mx);
+    for (int i = 0; i < FAKE_MAX_I2C_DEV; ++i) {
+        if (!i2c_devs[i].used) {
+            i2c_devs[i] = (struct i2c_master_dev_t){
+                .used = true, .addr = (uint16_t)cfg->device_address};
+            *out = &i2c_devs[i];
+            err  = ESP_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&i2c_mx);
+    return err;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t dev) {
+    pthread_mutex_lock(&i2c_mx);
+    dev->used = false;
+    pthread_mutex_unlock(&i2c_mx);
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev, const uint8_t *buf,
+                              size_t n, int timeout_ms) {
+    pthread_mutex_lock(&i2c_mx);
+    if (i2c_log_len < FAKE_I2C_LOG_MAX) {
+        i2c_log[i2c_log_len++] = (fake_i2c_xfer_t){
+            .addr = dev->addr, .first = n ? buf[0] : 0, .len = (uint16_t)n};
+    }
+    pthread_mutex_unlock(&i2c_mx);
+    if (dev->on_done) {
+        const i2c_master_event_data_t evt = {.event = I2C_EVENT_DONE};
+        dev->on_done(dev, &evt, dev->arg);
+    }
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_register_event_callbacks(
+    i2c_master_dev_handle_t dev, const i2c_master_event_callbacks_t *cbs,
+    void *arg) {
+    dev->on_done = cbs->on_trans_done;
+    dev->arg     = arg;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_wait_all_done(i2c_master_bus_handle_t bus,
+                                       int                     timeout_ms) {
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t bus) { return ESP_OK; }
+
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t bus, uint16_t addr,
+                           int timeout_ms) {
+    return ESP_OK;
+}
+
+size_t fake_i2c_log(const fake_i2c_xfer_t **out) {
+    pthread_mutex_lock(&i2c_mx);
+    const size_t n = i2c_log_len;
+    pthread_mutex_unlock(&i2c_mx);
+    *out = i2c_log;
+    return n;
+}
+
+void fake_i2c_log_clear(void) {
+    pthread_mutex_lock(&i2c_mx);
+    i2c_log_len = 0;
+    pthread_mutex_unlock(&i2c_mx);
+}
+
+// ---- SPI ----
+// Transactions complete as soon as they are queued.
+struct spi_device_t {
+    bool               used;
+    spi_transaction_t *q[FAKE_SPI_QUEUE];
+    unsigned           head, count;
+};
+
+static struct spi_device_t spi_devs[FAKE_MAX_SPI_DEV];
+static pthread_mutex_t     spi_mx = PTHREAD_MUTEX_INITIALIZER;
+
+esp_err_t spi_bus_add_device(spi_host_device_t                    host,
+                             const spi_device_interface_config_t *cfg,
+                             spi_device_handle_t                 *out) {
+    esp_err_t err = ESP_ERR_NO_MEM;
+    pthread_mutex_lock(&spi_mx);
+    for (int i = 0; i < FAKE_MAX_SPI_DEV; ++i) {
+        if (!spi_devs[i].used) {
+            spi_devs[i] = (struct spi_device_t){.used = true};
+            *out        = &spi_devs[i];
+            err         = ESP_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&spi_mx);
+    return err;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t dev) {
+    pthread_mutex_lock(&spi_mx);
+    dev->used = false;
+    pthread_mutex_unlock(&spi_mx);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t *t,
+                                 TickType_t ticks) {
+    esp_err_t err = ESP_ERR_TIMEOUT;
+    pthread_mutex_lock(&spi_mx);
+    if (dev->count < FAKE_SPI_QUEUE) {
+        dev->q[(dev->head + dev->count++) % FAKE_SPI_QUEUE] = t;
+        err                                                 = ESP_OK;
+    }
+    pthread_mutex_unlock(&spi_mx);
+    return err;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev,
+                                      spi_transaction_t **out,
+                                      TickType_t          ticks) {
+    esp_err_t err = ESP_ERR_TIMEOUT;
+    pthread_mutex_lock(&spi_mx);
+    if (dev->count) {
+        *out      = dev->q[dev->head];
+        dev->head = (dev->head + 1) % FAKE_SPI_QUEUE;
+        dev->count--;
+        err = ESP_OK;
+    }
+    pthread_mutex_unlock(&spi_mx);
+    return err;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t dev, TickType_t ticks) {
+    return ticks == portMAX_DELAY ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+void spi_device_release_bus(spi_device_handle_t dev) {}
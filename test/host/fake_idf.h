@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: MIT
+/*
+ * fake_idf.h - Controls for the host stand-ins of the IDF drivers
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// One I2C write as the panel or mux saw it: device address, first byte
+// (control byte, or the select byte for a mux) and length.
+typedef struct {
+    uint16_t addr;
+    uint8_t  first;
+    uint16_t len;
+} fake_i2c_xfer_t;
+
+// Writes since the last clear; the log keeps the first FAKE_I2C_LOG_MAX.
+#define FAKE_I2C_LOG_MAX 4096
+size_t fake_i2c_log(const fake_i2c_xfer_t **out);
+void   fake_i2c_log_clear(void);
+
+// While held, tasks blocked in ulTaskNotifyTake() stay blocked even when
+// notified, so several requests can pile up before a scheduler runs.
+void fake_tasks_hold(bool hold);
+// True once every task is blocked in ulTaskNotifyTake().
+bool fake_tasks_idle(void);
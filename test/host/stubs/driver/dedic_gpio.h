@@ -0,0 +1,9 @@
+#pragma once
+#include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+typedef struct dedic_gpio_bundle_t *dedic_gpio_bundle_handle_t;
+typedef struct { const int *gpio_array; size_t array_size; struct { unsigned in_en:1, in_invert:1, out_en:1, out_invert:1; } flags; } dedic_gpio_bundle_config_t;
+esp_err_t dedic_gpio_new_bundle(const dedic_gpio_bundle_config_t *, dedic_gpio_bundle_handle_t *);
+esp_err_t dedic_gpio_del_bundle(dedic_gpio_bundle_handle_t);
+void dedic_gpio_bundle_write(dedic_gpio_bundle_handle_t, uint32_t, uint32_t);
@@ -0,0 +1,10 @@
+#pragma once
+#include "esp_err.h"
+typedef enum { GPIO_NUM_NC = -1, GPIO_NUM_0 = 0, GPIO_NUM_21 = 21, GPIO_NUM_22 = 22, GPIO_NUM_MAX = 49 } gpio_num_t;
+typedef enum { GPIO_MODE_DISABLE, GPIO_MODE_OUTPUT } gpio_mode_t;
+#define GPIO_PULLUP_DISABLE 0
+#define GPIO_PULLDOWN_DISABLE 0
+#define GPIO_INTR_DISABLE 0
+typedef struct { uint64_t pin_bit_mask; gpio_mode_t mode; int pull_up_en, pull_down_en, intr_type; } gpio_config_t;
+esp_err_t gpio_config(const gpio_config_t *);
+esp_err_t gpio_set_level(gpio_num_t, uint32_t);
@@ -0,0 +1,20 @@
+#pragma once
+#include "esp_err.h"
+#include "driver/i2c_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+typedef struct { int device_address; unsigned scl_speed_hz; unsigned scl_wait_us; struct { unsigned disable_ack_check:1; } flags; int dev_addr_length; } i2c_device_config_t;
+typedef struct { int event; } i2c_master_event_data_t;
+typedef bool (*i2c_master_callback_t)(i2c_master_dev_handle_t, const i2c_master_event_data_t *, void *);
+typedef struct { i2c_master_callback_t on_trans_done; } i2c_master_event_callbacks_t;
+typedef struct { int i2c_port; int sda_io_num, scl_io_num; int clk_source; int glitch_ignore_cnt; size_t trans_queue_depth; struct { unsigned enable_internal_pullup:1; } flags; } i2c_master_bus_config_t;
+esp_err_t i2c_master_get_bus_handle(i2c_port_num_t, i2c_master_bus_handle_t *);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t, const i2c_device_config_t *, i2c_master_dev_handle_t *);
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t);
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t, const uint8_t *, size_t, int);
+esp_err_t i2c_master_register_event_callbacks(i2c_master_dev_handle_t, const i2c_master_event_callbacks_t *, void *);
+esp_err_t i2c_master_bus_wait_all_done(i2c_master_bus_handle_t, int);
+esp_err_t i2c_master_bus_reset(i2c_master_bus_handle_t);
+esp_err_t i2c_master_probe(i2c_master_bus_handle_t, uint16_t, int);
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t *, i2c_master_bus_handle_t *);
+#define I2C_CLK_SRC_DEFAULT 0
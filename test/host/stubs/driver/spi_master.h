@@ -0,0 +1,24 @@
+#pragma once
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stddef.h>
+typedef int spi_host_device_t;
+#define SPI2_HOST 1
+#define SPI3_HOST 2
+typedef struct spi_device_t *spi_device_handle_t;
+typedef struct spi_transaction_t { uint32_t flags; uint16_t cmd; uint64_t addr; size_t length; size_t rxlength; void *user; const void *tx_buffer; void *rx_buffer; uint8_t tx_data[4]; } spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t *);
+typedef struct { uint8_t command_bits, address_bits, dummy_bits, mode; int clock_speed_hz; int spics_io_num; uint32_t flags; int queue_size; transaction_cb_t pre_cb, post_cb; } spi_device_interface_config_t;
+#define SPI_TRANS_USE_TXDATA (1<<3)
+esp_err_t spi_bus_add_device(spi_host_device_t, const spi_device_interface_config_t *, spi_device_handle_t *);
+esp_err_t spi_bus_remove_device(spi_device_handle_t);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t, spi_transaction_t *);
+esp_err_t spi_device_polling_start(spi_device_handle_t, spi_transaction_t *, TickType_t);
+esp_err_t spi_device_polling_end(spi_device_handle_t, TickType_t);
+esp_err_t spi_device_queue_trans(spi_device_handle_t, spi_transaction_t *, TickType_t);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t, spi_transaction_t **, TickType_t);
+esp_err_t spi_device_acquire_bus(spi_device_handle_t, TickType_t);
+void spi_device_release_bus(spi_device_handle_t);
+typedef struct { int mosi_io_num, miso_io_num, sclk_io_num, quadwp_io_num, quadhd_io_num, max_transfer_sz; } spi_bus_config_t;
+#define SPI_DMA_CH_AUTO 3
+esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t *, int);
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdbool.h>
+bool esp_ptr_internal(const void *p);
+bool esp_ptr_dma_capable(const void *p);
+bool esp_ptr_external_ram(const void *p);
@@ -0,0 +1,35 @@
+#pragma once
+// Host stand-in for the FreeRTOS headers; see fake_idf.c.
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t StackType_t;
+#define portMAX_DELAY 0xffffffffu
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
+#define portTICK_PERIOD_MS 1
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define tskNO_AFFINITY 0x7fffffff
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+// One process-wide recursive lock stands in for all spinlocks.
+void fake_critical_enter(portMUX_TYPE *m);
+void fake_critical_exit(portMUX_TYPE *m);
+#define portENTER_CRITICAL(m) fake_critical_enter(m)
+#define portEXIT_CRITICAL(m) fake_critical_exit(m)
+#define portENTER_CRITICAL_ISR(m) fake_critical_enter(m)
+#define portEXIT_CRITICAL_ISR(m) fake_critical_exit(m)
+#define portENTER_CRITICAL_SAFE(m) fake_critical_enter(m)
+#define portEXIT_CRITICAL_SAFE(m) fake_critical_exit(m)
+#define portYIELD_FROM_ISR(x) (void)(x)
+#define spinlock_initialize(m) (void)(m)
+#define configMAX_PRIORITIES 25
+#define xPortInIsrContext() 0
+typedef struct { void *p[20]; } StaticSemaphore_t;
+typedef struct { void *p[90]; } StaticTask_t;
+#define portMUX_INITIALIZE(m) (void)(m)
+#define portNUM_PROCESSORS 2
@@ -0,0 +1,7 @@
+#pragma once
+#include "FreeRTOS.h"
+typedef void *QueueHandle_t;
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t size);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t t);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t t);
+void vQueueDelete(QueueHandle_t q);
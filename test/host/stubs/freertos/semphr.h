@@ -0,0 +1,19 @@
+#pragma once
+#include "FreeRTOS.h"
+#include "task.h"
+typedef void *SemaphoreHandle_t;
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t, UBaseType_t);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *);
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *);
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t, UBaseType_t, StaticSemaphore_t *);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t, BaseType_t *);
+void vSemaphoreDelete(SemaphoreHandle_t);
+UBaseType_t uxSemaphoreGetCount(SemaphoreHandle_t);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void);
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutexStatic(StaticSemaphore_t *);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t, TickType_t);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t);
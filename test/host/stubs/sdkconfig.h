@@ -0,0 +1,3 @@
+#pragma once
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 2
+#define SOC_DEDICATED_GPIO_SUPPORTED 1
@@ -0,0 +1,3 @@
+#pragma once
+#define SOC_DEDICATED_GPIO_SUPPORTED 1
+#define SOC_I2C_NUM 2
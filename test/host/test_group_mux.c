@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: MIT
+/*
+ * test_group_mux.c - Flush order of a display group behind an I2C mux
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ *
+ * Four panels sit on channels 0-3 of one stub mux. Requests pile up while the
+ * group's bus task is held, then the order of the flushes is read back from
+ * the fake I2C log: a write to the mux selects a channel, writes to the panel
+ * address belong to that channel's panel.
+ *
+ * With --bench, random rounds of requests are flushed by the group and, for
+ * comparison, in request order; mux selects and time per round are printed.
+ */
+
+#include "fake_idf.h"
+
+#include <esp_timer.h>
+#include <ssd1306.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PANELS     4
+#define WIDTH      128
+#define HEIGHT     64
+#define PANEL_ADDR 0x3C
+#define MUX_ADDR   0x70
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,   \
+                    #cond);                                                    \
+            return 1;                                                          \
+        }                                                                      \
+    } while (0)
+
+static ssd1306_i2c_mux_handle_t mux;
+static ssd1306_handle_t         panel[PANELS];
+static ssd1306_group_handle_t   group;
+
+// One round of requests: deadline per panel (0 = group default) and dirty
+// width in columns of page 0 (0 = not requested).
+typedef struct {
+    uint32_t deadline_ms[PANELS];
+    int      dirty[PANELS];
+} round_t;
+
+static int flush_order(int *order);
+
+static int setup(void) {
+    int order[PANELS * 4];
+    fake_i2c_log_clear();
+    CHECK(ssd1306_i2c_mux_new(I2C_NUM_0, MUX_ADDR, &mux) == ESP_OK);
+    for (int i = 0; i < PANELS; ++i) {
+        const ssd1306_config_t cfg = {
+            .bus       = SSD1306_I2C,
+            .width     = WIDTH,
+            .height    = HEIGHT,
+            .iface.i2c = {
+                .port        = I2C_NUM_0,
+                .addr        = PANEL_ADDR,
+                .rst_gpio    = GPIO_NUM_NC,
+                .mux         = mux,
+                .mux_channel = (uint8_t)i,
+            },
+        };
+        CHECK(ssd1306_new_i2c(&cfg, &panel[i]) == ESP_OK);
+        CHECK(ssd1306_display(panel[i]) == ESP_OK);
+    }
+    CHECK(flush_order(order) == PANELS); // tracks the selected channel
+    CHECK(ssd1306_group_new(NULL, &group) == ESP_OK);
+    for (int i = 0; i < PANELS; ++i)
+        CHECK(ssd1306_group_add(group, panel[i]) == ESP_OK);
+    return 0;
+}
+
+static void teardown(void) {
+    ssd1306_group_del(group);
+    for (int i = 0; i < PANELS; ++i)
+        ssd1306_del(panel[i]);
+    ssd1306_i2c_mux_del(mux);
+}
+
+static uint32_t group_flushes(void) {
+    uint32_t n = 0;
+    for (int i = 0; i < PANELS; ++i) {
+        ssd1306_group_stats_t st;
+        if (ssd1306_group_get_stats(group, panel[i], &st) == ESP_OK)
+            n += st.flushes;
+    }
+    return n;
+}
+
+// Wait until the bus task has flushed `until` panels in total and is
+// blocked again; false after two seconds.
+static bool wait_group(uint32_t until) {
+    for (int i = 0; i < 100000; ++i) {
+        if (group_flushes() >= until && fake_tasks_idle())
+            return true;
+        usleep(20);
+    }
+    return false;
+}
+
+static void draw(const round_t *r) {
+    for (int i = 0; i < PANELS; ++i) {
+        if (r->dirty[i])
+            ssd1306_draw_rect(panel[i], 0, 0, r->dirty[i], 8, true);
+    }
+}
+
+// Panels in the order their data went out since the log was cleared. The
+// selected channel carries over from the previous call.
+static int flush_order(int *order) {
+    static int             cur = -1;
+    const fake_i2c_xfer_t *log;
+    const size_t           n   = fake_i2c_log(&log);
+    int                    len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (log[i].addr == MUX_ADDR)
+            cur = __builtin_ctz(log[i].first);
+        else if (log[i].addr == PANEL_ADDR && (!len || order[len - 1] != cur))
+            order[len++] = cur;
+    }
+    return len;
+}
+
+static size_t mux_selects(void) {
+    const fake_i2c_xfer_t *log;
+    const size_t           n   = fake_i2c_log(&log);
+    size_t                 sel = 0;
+    for (size_t i = 0; i < n; ++i)
+        sel += log[i].addr == MUX_ADDR;
+    return sel;
+}
+
+// Request the round's panels in index order (or perm) while the bus task is
+// held, then let the group flush them all.
+static int run_group(const round_t *r, const int *perm) {
+    uint32_t want = group_flushes();
+    CHECK(wait_group(want));
+    draw(r);
+    fake_tasks_hold(true);
+    fake_i2c_log_clear();
+    for (int k = 0; k < PANELS; ++k) {
+        const int i = perm ? perm[k] : k;
+        if (r->dirty[i]) {
+            CHECK(ssd1306_group_request(group, panel[i], r->deadline_ms[i]) ==
+                  ESP_OK);
+            want++;
+        }
+    }
+    fake_tasks_hold(false);
+    CHECK(wait_group(want));
+    return 0;
+}
+
+static int expect_order(const char *name, const round_t *r, const int *want,
+                        int n) {
+    int order[PANELS * 4];
+    CHECK(run_group(r, NULL) == 0);
+    const int len = flush_order(order);
+    bool      ok  = len == n && !memcmp(order, want, n * sizeof(int));
+    printf("%-36s", name);
+    for (int i = 0; i < len; ++i)
+        printf(" %d", order[i]);
+    printf(ok ? "  ok\n" : "  FAILED\n");
+    CHECK(ok);
+    return 0;
+}
+
+static int test_order(void) {
+    // The setup flushes left channel 3 selected.
+
+    // Earliest deadline first, whatever the mux shows.
+    const round_t edf = {{80, 10, 40, 0}, {16, 16, 16, 0}};
+    CHECK(expect_order("earliest deadline first", &edf, (int[]){1, 2, 0}, 3) ==
+          0);
+
+    // Equal deadlines: the selected channel (0) first, then smallest area.
+    const round_t sel = {{50, 50, 50, 0}, {128, 8, 32, 0}};
+    CHECK(expect_order("selected channel, then smallest", &sel,
+                       (int[]){0, 1, 2}, 3) == 0);
+
+    // Channel 2 is selected but not requested: smallest area first.
+    const round_t small = {{50, 50, 0, 50}, {64, 8, 0, 32}};
+    CHECK(expect_order("smallest area first", &small, (int[]){1, 3, 0}, 3) ==
+          0);
+
+    // Channel 0 is selected; 1 ms earlier is within the slack.
+    const round_t slack = {{30, 29, 0, 0}, {128, 8, 0, 0}};
+    CHECK(expect_order("selected channel within slack", &slack,
+                       (int[]){0, 1}, 2) == 0);
+
+    // Channel 1 is selected; 10 ms earlier is beyond it.
+    const round_t late = {{20, 30, 0, 0}, {8, 8, 0, 0}};
+    CHECK(expect_order("earlier deadline beyond slack", &late, (int[]){0, 1},
+                       2) == 0);
+    return 0;
+}
+
+static int bench(void) {
+    enum { ROUNDS = 500 };
+    round_t rounds[ROUNDS];
+    int     perms[ROUNDS][PANELS];
+    srand(1);
+    for (int n = 0; n < ROUNDS; ++n) {
+        for (int i = 0; i < PANELS; ++i) {
+            rounds[n].deadline_ms[i] = 0;
+            rounds[n].dirty[i]       = rand() % 4 ? 1 + rand() % WIDTH : 0;
+            perms[n][i]              = i;
+        }
+        for (int i = PANELS - 1; i > 0; --i) {
+            const int j = rand() % (i + 1), t = perms[n][i];
+            perms[n][i] = perms[n][j];
+            perms[n][j] = t;
+        }
+    }
+
+    size_t  group_sel = 0, order_sel = 0;
+    int64_t group_us = 0, order_us = 0;
+    for (int n = 0; n < ROUNDS; ++n) {
+        const int64_t t0 = esp_timer_get_time();
+        CHECK(run_group(&rounds[n], perms[n]) == 0);
+        group_us += esp_timer_get_time() - t0;
+        group_sel += mux_selects();
+    }
+    for (int n = 0; n < ROUNDS; ++n) {
+        draw(&rounds[n]);
+        fake_i2c_log_clear();
+        const int64_t t0 = esp_timer_get_time();
+        for (int k = 0; k < PANELS; ++k) {
+            const int i = perms[n][k];
+            if (rounds[n].dirty[i])
+                CHECK(ssd1306_display(panel[i]) == ESP_OK);
+        }
+        order_us += esp_timer_get_time() - t0;
+        order_sel += mux_selects();
+    }
+
+    printf("%d rounds of up to %d panels behind one mux\n", ROUNDS, PANELS);
+    printf("  group:         %.2f mux selects/round, %.1f us/round "
+           "(includes waking the bus task)\n",
+           (double)group_sel / ROUNDS, (double)group_us / ROUNDS);
+    printf("  request order: %.2f mux selects/round, %.1f us/round\n",
+           (double)order_sel / ROUNDS, (double)order_us / ROUNDS);
+    CHECK(group_sel <= order_sel);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const bool run_bench = argc > 1 && !strcmp(argv[1], "--bench");
+    if (setup())
+        return 1;
+    const int ret = run_bench ? bench() : test_order();
+    teardown();
+    return ret;
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: MIT
+/*
+ * test_i2c_bus_mode.c - Blocking and async panels never share an I2C bus
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ *
+ * An async panel needs a bus with a transaction queue, which makes every
+ * write on it asynchronous; blocking panels send from stack buffers and
+ * frame in place, so binding one to that bus must fail, and the reverse too.
+ */
+
+#include <ssd1306.h>
+
+#include <stdio.h>
+
+#define WIDTH  128
+#define HEIGHT 64
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,   \
+                    #cond);                                                    \
+            return 1;                                                          \
+        }                                                                      \
+    } while (0)
+
+static ssd1306_config_t panel_cfg(i2c_port_num_t port, uint8_t addr,
+                                  uint8_t async_depth) {
+    return (ssd1306_config_t){
+        .bus       = SSD1306_I2C,
+        .width     = WIDTH,
+        .height    = HEIGHT,
+        .iface.i2c = {
+            .port        = port,
+            .addr        = addr,
+            .rst_gpio    = GPIO_NUM_NC,
+            .async_depth = async_depth,
+        },
+    };
+}
+
+int main(void) {
+    static uint8_t          fb[WIDTH * HEIGHT / 8];
+    static uint8_t          stage[SSD1306_STAGE_LEN(WIDTH, HEIGHT)];
+    static ssd1306_static_t mem = {.stage = stage};
+
+    ssd1306_handle_t async = NULL, blocking = NULL, other = NULL;
+    ssd1306_config_t cfg = panel_cfg(I2C_NUM_0, 0x3C, 4);
+    CHECK(ssd1306_new_i2c(&cfg, &async) == ESP_OK);
+    CHECK(ssd1306_draw_rect(async, 0, 0, 32, 16, true) == ESP_OK);
+    CHECK(ssd1306_display(async) == ESP_OK);
+    CHECK(ssd1306_wait_idle(async, 100) == ESP_OK);
+
+    // Blocking panels, heap or static, are refused on the async bus...
+    cfg = panel_cfg(I2C_NUM_0, 0x3D, 0);
+    CHECK(ssd1306_new_i2c(&cfg, &blocking) == ESP_ERR_INVALID_STATE);
+    cfg.fb     = fb;
+    cfg.fb_len = sizeof(fb);
+    CHECK(ssd1306_new_i2c_static(&cfg, &mem, &blocking) ==
+          ESP_ERR_INVALID_STATE);
+
+    // ...but fine on another port, which then refuses async panels.
+    cfg = panel_cfg(1, 0x3C, 0);
+    CHECK(ssd1306_new_i2c(&cfg, &other) == ESP_OK);
+    cfg = panel_cfg(1, 0x3D, 2);
+    CHECK(ssd1306_new_i2c(&cfg, &blocking) == ESP_ERR_INVALID_STATE);
+    CHECK(ssd1306_del(other) == ESP_OK);
+
+    // Once the async panel is gone, the port takes blocking panels again.
+    CHECK(ssd1306_del(async) == ESP_OK);
+    cfg = panel_cfg(I2C_NUM_0, 0x3D, 0);
+    CHECK(ssd1306_new_i2c(&cfg, &blocking) == ESP_OK);
+    CHECK(ssd1306_display(blocking) == ESP_OK);
+    CHECK(ssd1306_del(blocking) == ESP_OK);
+
+    printf("async and blocking panels kept on separate buses\n");
+    return 0;
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: MIT
+/*
+ * test_static_heap.c - Static handles never touch the heap
+ * Copyright (c) 2025 Jonathan Wåhrenberg
+ *
+ * malloc/calloc/realloc/free are wrapped at link time and counted while the
+ * trap is armed: across ssd1306_new_*_static(), drawing, full and partial
+ * flushes, incremental flushes, stats and ssd1306_del(). The fake I2C and
+ * SPI devices come from static pools, so every count is the driver's own.
+ */
+
+#include <driver/spi_master.h>
+#include <ssd1306.h>
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define WIDTH  128
+#define HEIGHT 64
+
+#define CHECK(cond)                                                            \
+    do {                                                                       \
+        if (!(cond)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,   \
+                    #cond);                                                    \
+            return 1;                                                          \
+        }                                                                      \
+    } while (0)
+
+static atomic_bool armed;
+static atomic_int  heap_calls;
+
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *p, size_t n);
+void  __real_free(void *p);
+
+static void note(const char *what, size_t n) {
+    if (atomic_load(&armed)) {
+        atomic_fetch_add(&heap_calls, 1);
+        fprintf(stderr, "trapped %s(%zu)\n", what, n);
+    }
+}
+
+void *__wrap_malloc(size_t n) {
+    note("malloc", n);
+    return __real_malloc(n);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    note("calloc", n * size);
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *p, size_t n) {
+    note("realloc", n);
+    return __real_realloc(p, n);
+}
+
+void __wrap_free(void *p) {
+    if (p)
+        note("free", 0);
+    __real_free(p);
+}
+
+// Everything a running application does with a handle.
+static int exercise(ssd1306_handle_t h) {
+    ssd1306_stats_t st;
+    bool            more = true;
+
+    CHECK(ssd1306_clear(h) == ESP_OK);
+    CHECK(ssd1306_draw_rect(h, 0, 0, WIDTH, HEIGHT, false) == ESP_OK);
+    CHECK(ssd1306_draw_text(h, 2, 2, "static", true) == ESP_OK);
+    CHECK(ssd1306_draw_circle(h, 64, 32, 20, true) == ESP_OK);
+    CHECK(ssd1306_display(h) == ESP_OK);
+
+    // Partial flushes: one page, then a narrow window across all pages.
+    CHECK(ssd1306_draw_line(h, 10, 20, 40, 20, true) == ESP_OK);
+    CHECK(ssd1306_display(h) == ESP_OK);
+    CHECK(ssd1306_draw_rect(h, 60, 0, 4, HEIGHT, true) == ESP_OK);
+    CHECK(ssd1306_display(h) == ESP_OK);
+
+    CHECK(ssd1306_clear(h) == ESP_OK);
+    for (int i = 0; i < 64 && more; ++i)
+        CHECK(ssd1306_display_step(h, 500, &more) == ESP_OK);
+    CHECK(!more);
+
+    CHECK(ssd1306_get_stats(h, &st) == ESP_OK);
+    CHECK(ssd1306_reset_stats(h) == ESP_OK);
+    return 0;
+}
+
+static int run(bool spi) {
+    static uint8_t          fb[WIDTH * HEIGHT / 8];
+    static uint8_t          stage[SSD1306_STAGE_LEN(WIDTH, HEIGHT)];
+    static uint8_t          gather[SSD1306_STAGE_LEN(WIDTH, HEIGHT)];
+    static ssd1306_static_t mem;
+
+    mem                  = (ssd1306_static_t){.stage = stage, .gather = gather};
+    ssd1306_config_t cfg = {
+        .fb         = fb,
+        .fb_len     = sizeof(fb),
+        .width      = WIDTH,
+        .height     = HEIGHT,
+        .lock_bands = 4,
+    };
+    if (spi) {
+        cfg.bus       = SSD1306_SPI;
+        cfg.iface.spi = (ssd1306_spi_cfg_t){
+            .host     = SPI2_HOST,
+            .cs_gpio  = 5,
+            .dc_gpio  = 16,
+            .rst_gpio = GPIO_NUM_NC,
+            .dc_mode  = SSD1306_SPI_DC_DIRECT,
+        };
+    } else {
+        cfg.bus       = SSD1306_I2C;
+        cfg.iface.i2c = (ssd1306_i2c_cfg_t){
+            .port     = I2C_NUM_0,
+            .addr     = 0x3C,
+            .rst_gpio = GPIO_NUM_NC,
+        };
+    }
+
+    ssd1306_handle_t h = NULL;
+    atomic_store(&heap_calls, 0);
+    atomic_store(&armed, true);
+    esp_err_t err = spi ? ssd1306_new_spi_static(&cfg, &mem, &h)
+                        : ssd1306_new_i2c_static(&cfg, &mem, &h);
+    int       ret = err == ESP_OK ? exercise(h) : 1;
+    if (h)
+        err = ssd1306_del(h);
+    atomic_store(&armed, false);
+
+    CHECK(ret == 0);
+    CHECK(err == ESP_OK);
+    CHECK(atomic_load(&heap_calls) == 0);
+    return 0;
+}
+
+int main(void) {
+    if (run(false) || run(true))
+        return 1;
+    printf("static I2C and SPI handles: no heap calls\n");
+    return 0;
+}